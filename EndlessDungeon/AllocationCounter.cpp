@@ -0,0 +1,46 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<long long> heapAllocations{ 0 };
+}
+
+// Replacing the global operator new counts every heap allocation in the program,
+// the array and nothrow forms forward to this one
+void* operator new(std::size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    for (;;)
+    {
+        if (void* memory = std::malloc(size > 0 ? size : 1)) { return memory; }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) { throw std::bad_alloc(); }
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+long long HeapAllocationCount()
+{
+    return heapAllocations.load(std::memory_order_relaxed);
+}
+#else
+long long HeapAllocationCount()
+{
+    return 0;
+}
+#endif
\ No newline at end of file
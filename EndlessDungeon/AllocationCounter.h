@@ -0,0 +1,13 @@
+#pragma once
+
+// Heap allocation counting replaces the global operator new, so it only exists in builds
+// with COUNT_HEAP_ALLOCATIONS defined. Other builds keep the standard allocator untouched.
+#ifdef COUNT_HEAP_ALLOCATIONS
+constexpr bool HEAP_ALLOCATIONS_COUNTED = true;
+#else
+constexpr bool HEAP_ALLOCATIONS_COUNTED = false;
+#endif
+
+// Every global operator new since startup, arenas included, to check hot paths stay off the heap.
+// Always 0 when HEAP_ALLOCATIONS_COUNTED is false.
+long long HeapAllocationCount();
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+Arena::Arena(size_t size) :
+    blockSize(size),
+    currentBlock(0),
+    offset(0),
+    allocations(0),
+    bytesUsed(0),
+    blockAllocations(0)
+{
+}
+
+Arena::~Arena()
+{
+    for (Block& block : blocks)
+    {
+        ::operator delete(block.data);
+    }
+}
+
+void Arena::reset()
+{
+    // A level or frame that spilled into several blocks gets one block big enough for all of it
+    if (blocks.size() > 1)
+    {
+        size_t total = capacity();
+        for (Block& block : blocks)
+        {
+            ::operator delete(block.data);
+        }
+        blocks.assign(1, Block{ static_cast<char*>(::operator new(total)), total });
+    }
+
+    currentBlock = 0;
+    offset = 0;
+    allocations = 0;
+    bytesUsed = 0;
+    blockAllocations = 0;
+}
+
+size_t Arena::capacity() const
+{
+    size_t total = 0;
+    for (const Block& block : blocks) { total += block.size; }
+    return total;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    allocations++;
+    bytesUsed += bytes;
+
+    // Later blocks are only there when an earlier reset kept them, try them before the heap
+    for (; currentBlock < blocks.size(); currentBlock++, offset = 0)
+    {
+        if (void* memory = allocateFrom(blocks[currentBlock], bytes, alignment)) { return memory; }
+    }
+
+    size_t size = std::max(blockSize, bytes + alignment);
+    blocks.push_back(Block{ static_cast<char*>(::operator new(size)), size });
+    blockAllocations++;
+    currentBlock = blocks.size() - 1;
+    offset = 0;
+    return allocateFrom(blocks.back(), bytes, alignment);
+}
+
+void* Arena::allocateFrom(Block& block, size_t bytes, size_t alignment)
+{
+    uintptr_t start = reinterpret_cast<uintptr_t>(block.data) + offset;
+    uintptr_t aligned = (start + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    size_t end = offset + (aligned - start) + bytes;
+    if (end > block.size) { return nullptr; }
+
+    offset = end;
+    return reinterpret_cast<void*>(aligned);
+}
\ No newline at end of file
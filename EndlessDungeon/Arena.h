@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Monotonic allocator for std::pmr containers: allocating bumps a pointer,
+// freeing does nothing and reset() drops everything at once. Blocks are kept
+// across resets, so once an arena has held its largest level or frame it stops
+// going to the heap.
+class Arena : public std::pmr::memory_resource
+{
+public:
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Invalidates every allocation, containers using the arena must be emptied first
+    void reset();
+
+    // Counted since the last reset
+    int allocation_count() const { return allocations; }
+    size_t bytes_used() const { return bytesUsed; }
+    int block_allocation_count() const { return blockAllocations; }
+
+    size_t capacity() const;
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void* allocateFrom(Block& block, size_t bytes, size_t alignment);
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t currentBlock;
+    size_t offset;
+    int allocations;
+    size_t bytesUsed;
+    int blockAllocations;
+};
\ No newline at end of file
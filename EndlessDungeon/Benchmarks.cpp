@@ -0,0 +1,459 @@
+#include "Benchmarks.h"
+#include "CaveGenerator.h"
+#include "JobSystem.h"
+#include "MapKernels.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Enough arithmetic per job that scheduling overhead doesn't dominate
+    float busyWork(int seed, int iterations)
+    {
+        float value = static_cast<float>(seed);
+        for (int i = 0; i < iterations; i++)
+        {
+            value = sqrtf(value * value + 1.0f) * 0.5f;
+        }
+        return value;
+    }
+
+    int benchmarkJobs()
+    {
+        const int FRAMES = 200;
+        const int FAN_OUT = 2048;
+        const int CHAINS = 32;
+        const int CHAIN_LENGTH = 32;
+        const int WORK_ITERATIONS = 400;
+
+        std::vector<int> workerCounts{ 0 };
+        const int maxWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        for (int workers = 1; workers < maxWorkers; workers *= 2) { workerCounts.push_back(workers); }
+        workerCounts.push_back(maxWorkers);
+
+        std::vector<float> results(FAN_OUT);
+        std::vector<std::atomic<int>> chainProgress(CHAINS);
+
+        printf("Job system: %d frames of %d independent jobs + %d chains of %d dependent jobs\n",
+            FRAMES, FAN_OUT, CHAINS, CHAIN_LENGTH);
+
+        double serialTime = 0.0;
+        for (int workers : workerCounts)
+        {
+            JobSystem jobs(workers);
+            std::atomic<int> orderErrors{ 0 };
+
+            double start = now();
+            for (int frame = 0; frame < FRAMES; frame++)
+            {
+                for (int i = 0; i < FAN_OUT; i++)
+                {
+                    jobs.schedule([&results, i] { results[i] = busyWork(i, WORK_ITERATIONS); });
+                }
+
+                // Each link checks the one before it has run
+                JobHandle firstChainEnd = JobSystem::NO_JOB;
+                for (int chain = 0; chain < CHAINS; chain++)
+                {
+                    chainProgress[chain] = 0;
+                    JobHandle previous = JobSystem::NO_JOB;
+                    for (int link = 0; link < CHAIN_LENGTH; link++)
+                    {
+                        previous = jobs.schedule([&chainProgress, &orderErrors, chain, link] {
+                            busyWork(link, WORK_ITERATIONS);
+                            if (chainProgress[chain].fetch_add(1) != link) { orderErrors++; }
+                        }, { previous });
+                    }
+                    if (chain == 0) { firstChainEnd = previous; }
+                }
+
+                // Waiting runs that chain on this thread if nobody else has, but none of the fan-out
+                jobs.wait(firstChainEnd);
+                if (chainProgress[0] != CHAIN_LENGTH) { orderErrors++; }
+
+                jobs.sync();
+            }
+            double elapsed = now() - start;
+            if (workers == 0) { serialTime = elapsed; }
+
+            printf("  %2d workers: %8.3f ms/frame  speedup %5.2fx  order errors %d\n",
+                workers, elapsed * 1000.0 / FRAMES, serialTime / elapsed, orderErrors.load());
+            if (orderErrors > 0) { return 1; }
+        }
+        return 0;
+    }
+
+    // One byte per cell and a ring of wall around the map, so the 4-5 rule needs no bounds
+    // checks. This is the plain loop CaveGenerator::smooth is measured against.
+    void smoothPadded(const std::vector<uint8_t>& cells, std::vector<uint8_t>& next, int width, int height)
+    {
+        const int stride = width + 2;
+        for (int y = 1; y <= height; y++)
+        {
+            for (int x = 1; x <= width; x++)
+            {
+                const uint8_t* above = &cells[(y - 1) * stride + x];
+                const uint8_t* row = above + stride;
+                const uint8_t* below = row + stride;
+                int walls = above[-1] + above[0] + above[1] + row[-1] + row[0] + row[1] + below[-1] + below[0] + below[1];
+                next[y * stride + x] = walls >= 5 ? 1 : 0;
+            }
+        }
+
+        // The map's outer ring stays solid, as CaveGenerator keeps it
+        for (int x = 1; x <= width; x++)
+        {
+            next[stride + x] = 1;
+            next[height * stride + x] = 1;
+        }
+        for (int y = 1; y <= height; y++)
+        {
+            next[y * stride + 1] = 1;
+            next[y * stride + width] = 1;
+        }
+    }
+
+    int benchmarkCaves()
+    {
+        const int SIZES[] = { 256, 1024, 4096 };
+        const uint64_t SEED = 12345;
+
+        printf("Cave smoothing: %d steps of the 4-5 rule, 64-bit words vs a padded byte grid\n", CaveGenerator::SMOOTHING_STEPS);
+        for (int size : SIZES)
+        {
+            CaveGenerator packed(size, size);
+            packed.fill(SEED);
+
+            const int stride = size + 2;
+            std::vector<uint8_t> cells(static_cast<size_t>(stride) * stride, 1);
+            std::vector<uint8_t> next(cells);
+            for (int y = 0; y < size; y++)
+            {
+                for (int x = 0; x < size; x++) { cells[(y + 1) * stride + x + 1] = packed.is_wall(x, y) ? 1 : 0; }
+            }
+
+            double start = now();
+            for (int step = 0; step < CaveGenerator::SMOOTHING_STEPS; step++) { packed.smooth(); }
+            double packedTime = now() - start;
+
+            start = now();
+            for (int step = 0; step < CaveGenerator::SMOOTHING_STEPS; step++)
+            {
+                smoothPadded(cells, next, size, size);
+                std::swap(cells, next);
+            }
+            double scalarTime = now() - start;
+
+            bool matches = true;
+            for (int y = 0; y < size && matches; y++)
+            {
+                for (int x = 0; x < size; x++)
+                {
+                    if (packed.is_wall(x, y) != (cells[(y + 1) * stride + x + 1] != 0)) { matches = false; }
+                }
+            }
+            printf("  %4dx%-4d  words %9.3f ms  bytes %9.3f ms  speedup %6.1fx  %s\n",
+                size, size, packedTime * 1000.0, scalarTime * 1000.0, scalarTime / packedTime,
+                matches ? "identical" : "MISMATCH");
+            if (!matches) { return 1; }
+
+            // Whole generator including the flood fill that drops unreachable caves
+            start = now();
+            packed.generate(SEED);
+            printf("             full generate %9.3f ms, %d floor cells\n", (now() - start) * 1000.0, packed.floor_count());
+        }
+        return 0;
+    }
+
+    int benchmarkSpatial()
+    {
+        const int FRAMES = 60;
+        const int OBJECTS = 10000;
+        const int GRID_SIZE = 128;
+        const int QUERIES = 500;
+        const int RESPAWNS = 50;
+        const int MAX_RESULTS = 256;
+        const int MAX_HITS = 4;
+        const float QUERY_RADIUS = 3.0f;
+        const float BOX_SIZE = 6.0f;
+        const float RAY_LENGTH = 24.0f;
+        const float FRAME_TIME = 1.0f / 60.0f;
+        const Vector3 ORIGIN{ -64.0f, 0.0f, -64.0f };
+
+        uint32_t state = 12345;
+        auto random = [&state](float low, float high)
+        {
+            state = state * 1664525u + 1013904223u;
+            return low + (high - low) * static_cast<float>(state >> 8) / 16777216.0f;
+        };
+
+        // Objects roam the grid and bounce off its edges
+        const float minCoord = ORIGIN.x - 0.5f;
+        const float maxCoord = ORIGIN.x - 0.5f + GRID_SIZE;
+        SpatialGrid grid;
+        grid.reset(GRID_SIZE, GRID_SIZE, ORIGIN);
+        std::vector<Vector2> positions(OBJECTS);
+        std::vector<Vector2> velocities(OBJECTS);
+        std::vector<float> radii(OBJECTS);
+        for (int i = 0; i < OBJECTS; i++)
+        {
+            positions[i] = Vector2{ random(minCoord, maxCoord), random(minCoord, maxCoord) };
+            velocities[i] = Vector2{ random(-4.0f, 4.0f), random(-4.0f, 4.0f) };
+            radii[i] = random(0.1f, 0.5f);
+            grid.insert(positions[i], radii[i]);
+        }
+
+        std::vector<ObjectId> results(MAX_RESULTS);
+        std::vector<RayHit> hits(MAX_HITS);
+        double moveTime = 0.0, gridTime[3] = {}, bruteTime[3] = {};
+        long long gridFound[3] = {}, bruteFound[3] = {};
+        int mismatches = 0;
+
+        printf("Spatial grid: %d moving objects on %dx%d cells, %d radius/box/ray queries per frame\n",
+            OBJECTS, GRID_SIZE, GRID_SIZE, QUERIES);
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            double start = now();
+            for (int i = 0; i < OBJECTS; i++)
+            {
+                Vector2& p = positions[i];
+                Vector2& v = velocities[i];
+                p.x += v.x * FRAME_TIME;
+                p.y += v.y * FRAME_TIME;
+                if (p.x < minCoord || p.x > maxCoord) { v.x = -v.x; }
+                if (p.y < minCoord || p.y > maxCoord) { v.y = -v.y; }
+                grid.move(i, p);
+            }
+
+            // Some despawn and come back elsewhere, the free list hands the same id back
+            for (int r = 0; r < RESPAWNS; r++)
+            {
+                ObjectId id = (frame * RESPAWNS + r) % OBJECTS;
+                grid.remove(id);
+                positions[id] = Vector2{ random(minCoord, maxCoord), random(minCoord, maxCoord) };
+                radii[id] = random(0.1f, 0.5f);
+                if (grid.insert(positions[id], radii[id]) != id) { mismatches++; }
+            }
+            moveTime += now() - start;
+
+            for (int q = 0; q < QUERIES; q++)
+            {
+                Vector2 center{ random(minCoord, maxCoord), random(minCoord, maxCoord) };
+                Rectangle box{ center.x, center.y, BOX_SIZE, BOX_SIZE };
+                float angle = random(0.0f, 2.0f * PI);
+                Vector2 direction{ cosf(angle), sinf(angle) };
+
+                start = now();
+                int found = grid.query_radius(center, QUERY_RADIUS, results.data(), MAX_RESULTS);
+                gridTime[0] += now() - start;
+                gridFound[0] += found;
+
+                start = now();
+                int expected = 0;
+                for (int i = 0; i < OBJECTS; i++)
+                {
+                    float dx = positions[i].x - center.x, dz = positions[i].y - center.y;
+                    float range = QUERY_RADIUS + radii[i];
+                    if (dx * dx + dz * dz <= range * range) { expected++; }
+                }
+                bruteTime[0] += now() - start;
+                bruteFound[0] += expected;
+                if (found != expected) { mismatches++; }
+
+                start = now();
+                found = grid.query_box(box, results.data(), MAX_RESULTS);
+                gridTime[1] += now() - start;
+                gridFound[1] += found;
+
+                start = now();
+                expected = 0;
+                for (int i = 0; i < OBJECTS; i++)
+                {
+                    if (CheckCollisionCircleRec(positions[i], radii[i], box)) { expected++; }
+                }
+                bruteTime[1] += now() - start;
+                bruteFound[1] += expected;
+                if (found != expected) { mismatches++; }
+
+                start = now();
+                found = grid.query_ray(center, direction, RAY_LENGTH, hits.data(), MAX_HITS);
+                gridTime[2] += now() - start;
+                gridFound[2] += found;
+
+                // Brute force counts the hits and keeps the nearest, compared with the grid's first
+                start = now();
+                // Normalized the way query_ray does it, grazing hits are too sensitive to a last-bit difference
+                const float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+                const Vector2 dir{ direction.x / length, direction.y / length };
+                float nearest = INFINITY;
+                expected = 0;
+                for (int i = 0; i < OBJECTS; i++)
+                {
+                    float toX = center.x - positions[i].x, toZ = center.y - positions[i].y;
+                    float b = toX * dir.x + toZ * dir.y;
+                    float c = toX * toX + toZ * toZ - radii[i] * radii[i];
+                    float distance = 0.0f;
+                    if (c > 0.0f)
+                    {
+                        float discriminant = b * b - c;
+                        if (b > 0.0f || discriminant < 0.0f) { continue; }
+                        distance = -b - sqrtf(discriminant);
+                    }
+                    if (distance > RAY_LENGTH) { continue; }
+                    nearest = std::min(nearest, distance);
+                    expected++;
+                }
+                bruteTime[2] += now() - start;
+                expected = std::min(expected, MAX_HITS);
+                bruteFound[2] += expected;
+
+                if (found != expected || (found > 0 && fabsf(hits[0].distance - nearest) > 1e-3f)) { mismatches++; }
+            }
+        }
+
+        const char* NAMES[] = { "radius", "box", "ray" };
+        const int totalQueries = FRAMES * QUERIES;
+        printf("  move      %8.3f ms/frame (with %d respawns)\n", moveTime * 1000.0 / FRAMES, RESPAWNS);
+        for (int kind = 0; kind < 3; kind++)
+        {
+            printf("  %-6s  grid %7.2f us/query  brute %7.2f us/query  speedup %6.1fx  avg results %.1f/%.1f\n",
+                NAMES[kind], gridTime[kind] * 1e6 / totalQueries, bruteTime[kind] * 1e6 / totalQueries,
+                bruteTime[kind] / gridTime[kind], static_cast<double>(gridFound[kind]) / totalQueries,
+                static_cast<double>(bruteFound[kind]) / totalQueries);
+        }
+        printf("  %d mismatches against brute force\n", mismatches);
+        return mismatches > 0 ? 1 : 0;
+    }
+
+    template <typename Body>
+    double timed(Body body)
+    {
+        double start = now();
+        body();
+        return now() - start;
+    }
+
+    // Same kernels with the map size as template arguments and read at run time
+    template <int SIZE>
+    bool benchmarkKernelSize()
+    {
+        using Fixed = MapKernels<FixedGrid<SIZE, SIZE>>;
+        using Generic = MapKernels<DynamicGrid>;
+        const int COLLISION_CHECKS = 200000;
+        const int VISIBILITY_UPDATES = 20000;
+        const int MINIMAP_FRAMES = 5000;
+        const float PLAYER_RADIUS = 0.1f;
+        const float VISIBILITY_RADIUS = 5.0f;
+        const Vector2 ORIGIN{ -16.0f, -8.0f };
+
+        // Through a volatile so the compiler can't fold the size into the generic path
+        volatile int runtimeSize = SIZE;
+        const int size = runtimeSize;
+
+        CaveGenerator caves(size, size);
+        caves.generate(SIZE);
+        std::pmr::vector<CellType> cells(size * size);
+        caves.write(cells);
+
+        std::vector<Vector2> positions;
+        std::vector<int> floorCells;
+        for (int i = 0; i < size * size; i++)
+        {
+            if (cells[i] == CellType::FLOOR) { floorCells.push_back(i); }
+        }
+        for (int i = 0; i < COLLISION_CHECKS; i++)
+        {
+            // Spread over floor cells, up to half a cell off centre so some of them touch walls
+            int cell = floorCells[(i * 7919) % floorCells.size()];
+            float offsetX = ((i * 37) % 101) / 100.0f - 0.5f;
+            float offsetY = ((i * 53) % 101) / 100.0f - 0.5f;
+            positions.push_back(Vector2{ ORIGIN.x + cell % size + offsetX, ORIGIN.y + cell / size + offsetY });
+        }
+
+        std::vector<char> fixedVisible(size * size, 0), genericVisible(size * size, 0);
+        std::vector<Color> fixedPixels(size * size), genericPixels(size * size);
+        int fixedHits = 0, genericHits = 0;
+
+        // Best of a few rounds, alternating so neither side always runs cold
+        const int ROUNDS = 5;
+        double fixedTimes[3] = { INFINITY, INFINITY, INFINITY };
+        double genericTimes[3] = { INFINITY, INFINITY, INFINITY };
+        for (int round = 0; round < ROUNDS; round++)
+        {
+            fixedHits = 0;
+            genericHits = 0;
+            fixedTimes[0] = std::min(fixedTimes[0], timed([&] {
+                for (const Vector2& p : positions) { fixedHits += Fixed::check_collision(cells.data(), size, size, ORIGIN, p, PLAYER_RADIUS); }
+            }));
+            genericTimes[0] = std::min(genericTimes[0], timed([&] {
+                for (const Vector2& p : positions) { genericHits += Generic::check_collision(cells.data(), size, size, ORIGIN, p, PLAYER_RADIUS); }
+            }));
+            fixedTimes[1] = std::min(fixedTimes[1], timed([&] {
+                for (int i = 0; i < VISIBILITY_UPDATES; i++)
+                {
+                    int cell = floorCells[(i * 7919) % floorCells.size()];
+                    Fixed::update_visibility(cells.data(), fixedVisible.data(), size, size, cell % size, cell / size, VISIBILITY_RADIUS);
+                }
+            }));
+            genericTimes[1] = std::min(genericTimes[1], timed([&] {
+                for (int i = 0; i < VISIBILITY_UPDATES; i++)
+                {
+                    int cell = floorCells[(i * 7919) % floorCells.size()];
+                    Generic::update_visibility(cells.data(), genericVisible.data(), size, size, cell % size, cell / size, VISIBILITY_RADIUS);
+                }
+            }));
+            fixedTimes[2] = std::min(fixedTimes[2], timed([&] {
+                for (int i = 0; i < MINIMAP_FRAMES; i++) { Fixed::create_map_pixels(cells.data(), fixedVisible.data(), size, size, fixedPixels.data()); }
+            }));
+            genericTimes[2] = std::min(genericTimes[2], timed([&] {
+                for (int i = 0; i < MINIMAP_FRAMES; i++) { Generic::create_map_pixels(cells.data(), genericVisible.data(), size, size, genericPixels.data()); }
+            }));
+        }
+
+        bool matches = fixedHits == genericHits && fixedVisible == genericVisible &&
+            memcmp(fixedPixels.data(), genericPixels.data(), fixedPixels.size() * sizeof(Color)) == 0;
+
+        const char* NAMES[] = { "collision", "visibility", "minimap" };
+        const int CALLS[] = { COLLISION_CHECKS, VISIBILITY_UPDATES, MINIMAP_FRAMES };
+        printf("  %dx%d (%d floor cells, %s)\n", SIZE, SIZE, static_cast<int>(floorCells.size()), matches ? "identical" : "MISMATCH");
+        for (int kernel = 0; kernel < 3; kernel++)
+        {
+            printf("    %-10s  specialised %9.3f us  generic %9.3f us  speedup %5.2fx\n", NAMES[kernel],
+                fixedTimes[kernel] * 1e6 / CALLS[kernel], genericTimes[kernel] * 1e6 / CALLS[kernel],
+                genericTimes[kernel] / fixedTimes[kernel]);
+        }
+        return matches;
+    }
+
+    int benchmarkKernels()
+    {
+        printf("Map kernels: per call, sizes baked in as template arguments vs read at run time\n");
+        bool matches = benchmarkKernelSize<32>();
+        matches = benchmarkKernelSize<64>() && matches;
+        matches = benchmarkKernelSize<128>() && matches;
+        return matches ? 0 : 1;
+    }
+}
+
+int RunBenchmark(const char* name)
+{
+    if (strcmp(name, "jobs") == 0) { return benchmarkJobs(); }
+    if (strcmp(name, "caves") == 0) { return benchmarkCaves(); }
+    if (strcmp(name, "spatial") == 0) { return benchmarkSpatial(); }
+    if (strcmp(name, "kernels") == 0) { return benchmarkKernels(); }
+
+    printf("Unknown benchmark '%s', available: jobs, caves, spatial, kernels\n", name);
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+// Standalone benchmarks, run with --bench <name>. Returns the process exit code.
+int RunBenchmark(const char* name);
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "Camera.h"
 #include <raymath.h>
 
-CameraController::CameraController(Map& mapRef) : map(mapRef)
+CameraController::CameraController(Map& mapRef, const Input& inputRef) : map(mapRef), input(inputRef)
 {
 }
 
@@ -33,7 +33,7 @@ void CameraController::update()
 
 void CameraController::update_camera_angle()
 {
-    float mouseOffsetX = GetMouseDelta().x * 0.003f;
+    float mouseOffsetX = input.get_mouse_delta().x * 0.003f;
     Vector3 forward = Vector3Subtract(camera.target, camera.position);
     float rotationAngle = atan2f(forward.x, forward.z);
     rotationAngle -= mouseOffsetX;
@@ -46,10 +46,10 @@ void CameraController::update_camera_angle()
 void CameraController::update_camera_normalized()
 {
     Vector3 direction = {};
-    if (IsKeyDown(KEY_W)) direction.z += 1.0f;
-    if (IsKeyDown(KEY_S)) direction.z -= 1.0f;
-    if (IsKeyDown(KEY_A)) direction.x -= 1.0f;
-    if (IsKeyDown(KEY_D)) direction.x += 1.0f;
+    if (input.is_key_down(KEY_W)) direction.z += 1.0f;
+    if (input.is_key_down(KEY_S)) direction.z -= 1.0f;
+    if (input.is_key_down(KEY_A)) direction.x -= 1.0f;
+    if (input.is_key_down(KEY_D)) direction.x += 1.0f;
 
     if (Vector3Length(direction) > 0)
     {
@@ -77,7 +77,7 @@ void CameraController::update_camera_normalized()
     camera.position = newPosition;
     camera.target = Vector3Add(camera.position, forward);
 
-    if (GetMouseDelta().x != 0.0f)
+    if (input.get_mouse_delta().x != 0.0f)
     {
         update_camera_angle();
     }
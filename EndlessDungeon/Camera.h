@@ -1,11 +1,12 @@
 #pragma once
 #include "raylib.h"
+#include "Input.h"
 #include "Map.h"
 
 class CameraController
 {
 public:
-    CameraController(Map& mapRef);
+    CameraController(Map& mapRef, const Input& inputRef);
     void initialize();
     void update();
     Camera GetCamera() { return camera; }
@@ -19,4 +20,5 @@ private:
     Camera camera;
     Vector3 oldPosition;
     Map& map;
+    const Input& input;
 };
\ No newline at end of file
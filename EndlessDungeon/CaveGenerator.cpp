@@ -0,0 +1,299 @@
+#include "CaveGenerator.h"
+#include "Map.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    uint64_t nextRandom(uint64_t& state)
+    {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    int popCount(uint64_t bits)
+    {
+        bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+        bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<int>((bits * 0x0101010101010101ull) >> 56);
+    }
+
+    int countTrailingZeros(uint64_t bits)
+    {
+        // De Bruijn lookup, bits must not be zero
+        static const int TABLE[64] = {
+            0, 1, 2, 53, 3, 7, 54, 27, 4, 38, 41, 8, 34, 55, 48, 28,
+            62, 5, 39, 46, 44, 42, 22, 9, 24, 35, 59, 56, 49, 18, 29, 11,
+            63, 52, 6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+            51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12
+        };
+        return TABLE[((bits & (~bits + 1)) * 0x022FDD63CC95386Dull) >> 58];
+    }
+
+    // Carry of a full adder, set where at least two of the inputs are
+    uint64_t majority(uint64_t a, uint64_t b, uint64_t c)
+    {
+        return (a & b) | (c & (a ^ b));
+    }
+}
+
+CaveGenerator::CaveGenerator(int mapWidth, int mapHeight, std::pmr::memory_resource* resource) :
+    width(mapWidth),
+    height(mapHeight),
+    wordsPerRow((mapWidth + 63) / 64),
+    lastWordMask(mapWidth % 64 == 0 ? ~0ull : (1ull << (mapWidth % 64)) - 1),
+    cells(static_cast<size_t>(wordsPerRow) * mapHeight, resource),
+    next(cells.size(), resource),
+    sumLow(cells.size(), resource),
+    sumHigh(cells.size(), resource)
+{
+}
+
+void CaveGenerator::generate(uint64_t seed, int steps)
+{
+    fill(seed);
+    for (int step = 0; step < steps; step++)
+    {
+        smooth();
+    }
+    keep_largest_cave();
+}
+
+void CaveGenerator::fill(uint64_t seed)
+{
+    uint64_t state = seed != 0 ? seed : 0x9E3779B97F4A7C15ull;
+
+    // r1 & (r2 | r3 | r4 | r5) sets each bit with probability 15/32, a ~47% wall start
+    for (uint64_t& word : cells)
+    {
+        uint64_t r1 = nextRandom(state);
+        uint64_t r2 = nextRandom(state);
+        uint64_t r3 = nextRandom(state);
+        uint64_t r4 = nextRandom(state);
+        uint64_t r5 = nextRandom(state);
+        word = r1 & (r2 | r3 | r4 | r5);
+    }
+    sealBorder();
+}
+
+void CaveGenerator::smooth()
+{
+    // Bit-sliced sum of every cell and its left and right neighbours (0-3, two bit planes)
+    for (int y = 0; y < height; y++)
+    {
+        const uint64_t* row = &cells[static_cast<size_t>(y) * wordsPerRow];
+        uint64_t* low = &sumLow[static_cast<size_t>(y) * wordsPerRow];
+        uint64_t* high = &sumHigh[static_cast<size_t>(y) * wordsPerRow];
+        for (int w = 0; w < wordsPerRow; w++)
+        {
+            uint64_t center = row[w];
+            uint64_t left = (center << 1) | (w > 0 ? row[w - 1] >> 63 : 1ull);
+            uint64_t right = (center >> 1) | (w + 1 < wordsPerRow ? row[w + 1] << 63 : 1ull << 63);
+            low[w] = left ^ center ^ right;
+            high[w] = majority(left, center, right);
+        }
+    }
+
+    // Add the sums of the rows above and below, outside the map is all wall (a sum of 3)
+    for (int y = 0; y < height; y++)
+    {
+        const size_t rowStart = static_cast<size_t>(y) * wordsPerRow;
+        const uint64_t* midLow = &sumLow[rowStart];
+        const uint64_t* midHigh = &sumHigh[rowStart];
+        const uint64_t* upLow = y > 0 ? midLow - wordsPerRow : nullptr;
+        const uint64_t* upHigh = y > 0 ? midHigh - wordsPerRow : nullptr;
+        const uint64_t* downLow = y + 1 < height ? midLow + wordsPerRow : nullptr;
+        const uint64_t* downHigh = y + 1 < height ? midHigh + wordsPerRow : nullptr;
+        uint64_t* out = &next[rowStart];
+
+        for (int w = 0; w < wordsPerRow; w++)
+        {
+            uint64_t u0 = upLow ? upLow[w] : ~0ull, u1 = upHigh ? upHigh[w] : ~0ull;
+            uint64_t d0 = downLow ? downLow[w] : ~0ull, d1 = downHigh ? downHigh[w] : ~0ull;
+
+            // total = ones + 2 * twos + 4 * fours + 8 * eights
+            uint64_t ones = u0 ^ midLow[w] ^ d0;
+            uint64_t lowCarry = majority(u0, midLow[w], d0);
+            uint64_t highSum = u1 ^ midHigh[w] ^ d1;
+            uint64_t highCarry = majority(u1, midHigh[w], d1);
+            uint64_t twos = lowCarry ^ highSum;
+            uint64_t twosCarry = lowCarry & highSum;
+            uint64_t fours = highCarry ^ twosCarry;
+            uint64_t eights = highCarry & twosCarry;
+
+            // Wall when total >= 5
+            out[w] = eights | (fours & (ones | twos));
+        }
+    }
+
+    std::swap(cells, next);
+    sealBorder();
+}
+
+int CaveGenerator::keep_largest_cave()
+{
+    // Label caves by their horizontal floor runs instead of cell by cell: runs on
+    // neighbouring rows that overlap are joined in a union-find
+    struct Run {
+        int start;
+        int end;        // Exclusive
+        int parent;
+        int size;       // Cells in the cave, kept up to date on roots only
+    };
+
+    // A run starts at a floor cell with a wall to its left and ends at the next wall.
+    // Count them first so the runs take one allocation, however big the map.
+    size_t runCount = 0;
+    for (int y = 0; y < height; y++)
+    {
+        for (int w = 0; w < wordsPerRow; w++)
+        {
+            runCount += popCount(runStarts(y, w));
+        }
+    }
+
+    std::pmr::memory_resource* resource = cells.get_allocator().resource();
+    std::pmr::vector<Run> runs(resource);
+    std::pmr::vector<int> rowBegin(static_cast<size_t>(height) + 1, 0, resource);
+    runs.reserve(runCount);
+
+    auto find = [&runs](int run)
+    {
+        while (runs[run].parent != run)
+        {
+            runs[run].parent = runs[runs[run].parent].parent;
+            run = runs[run].parent;
+        }
+        return run;
+    };
+
+    for (int y = 0; y < height; y++)
+    {
+        const int begin = static_cast<int>(runs.size());
+        rowBegin[y] = begin;
+        const uint64_t* row = &cells[static_cast<size_t>(y) * wordsPerRow];
+
+        // Starts and ends alternate along the row, padding past the edge is wall so every run ends
+        int nextEnd = begin;
+        for (int w = 0; w < wordsPerRow; w++)
+        {
+            for (uint64_t starts = runStarts(y, w); starts != 0; starts &= starts - 1)
+            {
+                int x = w * 64 + countTrailingZeros(starts);
+                runs.push_back(Run{ x, x, static_cast<int>(runs.size()), 0 });
+            }
+
+            uint64_t before = w > 0 ? ~row[w - 1] >> 63 : 0ull;
+            for (uint64_t ends = row[w] & ((~row[w] << 1) | before); ends != 0; ends &= ends - 1)
+            {
+                Run& run = runs[nextEnd++];
+                run.end = w * 64 + countTrailingZeros(ends);
+                run.size = run.end - run.start;
+            }
+        }
+
+        // Both rows are sorted by start, walk them together
+        int above = y > 0 ? rowBegin[y - 1] : begin;
+        for (int run = begin; run < static_cast<int>(runs.size()); run++)
+        {
+            while (above < begin && runs[above].end <= runs[run].start) { above++; }
+            for (int other = above; other < begin && runs[other].start < runs[run].end; other++)
+            {
+                int a = find(run);
+                int b = find(other);
+                if (a != b)
+                {
+                    runs[a].parent = b;
+                    runs[b].size += runs[a].size;
+                }
+            }
+        }
+    }
+    rowBegin[height] = static_cast<int>(runs.size());
+
+    int largest = -1;
+    for (int run = 0; run < static_cast<int>(runs.size()); run++)
+    {
+        if (runs[run].parent == run && (largest < 0 || runs[run].size > runs[largest].size)) { largest = run; }
+    }
+
+    // Everything outside the largest cave becomes wall
+    std::fill(cells.begin(), cells.end(), ~0ull);
+    if (largest < 0) { return 0; }
+    for (int y = 0; y < height; y++)
+    {
+        uint64_t* row = &cells[static_cast<size_t>(y) * wordsPerRow];
+        for (int run = rowBegin[y]; run < rowBegin[y + 1]; run++)
+        {
+            if (find(run) != largest)
+                continue;
+
+            for (int x = runs[run].start; x < runs[run].end;)
+            {
+                int bit = x % 64;
+                int count = std::min(64 - bit, runs[run].end - x);
+                uint64_t mask = (count == 64 ? ~0ull : ((1ull << count) - 1)) << bit;
+                row[x / 64] &= ~mask;
+                x += count;
+            }
+        }
+    }
+    sealBorder();
+    return runs[largest].size;
+}
+
+uint64_t CaveGenerator::runStarts(int y, int w) const
+{
+    // Floor cells whose left neighbour is a wall, the map's left edge counts as one
+    const uint64_t* row = &cells[static_cast<size_t>(y) * wordsPerRow];
+    uint64_t leftWalls = (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 1ull);
+    return ~row[w] & leftWalls;
+}
+
+bool CaveGenerator::is_wall(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height) { return true; }
+    return (cells[static_cast<size_t>(y) * wordsPerRow + x / 64] >> (x % 64)) & 1;
+}
+
+int CaveGenerator::floor_count() const
+{
+    int walls = 0;
+    for (uint64_t word : cells)
+    {
+        walls += popCount(word);
+    }
+    // Padding bits are always walls
+    return wordsPerRow * 64 * height - walls;
+}
+
+void CaveGenerator::write(std::pmr::vector<CellType>& mapData) const
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            mapData[y * width + x] = is_wall(x, y) ? CellType::WALL : CellType::FLOOR;
+        }
+    }
+}
+
+void CaveGenerator::sealBorder()
+{
+    // Solid outer ring, and padding past the right edge reads as wall
+    for (int w = 0; w < wordsPerRow; w++)
+    {
+        cells[w] = ~0ull;
+        cells[static_cast<size_t>(height - 1) * wordsPerRow + w] = ~0ull;
+    }
+    for (int y = 0; y < height; y++)
+    {
+        uint64_t* row = &cells[static_cast<size_t>(y) * wordsPerRow];
+        row[0] |= 1ull;
+        row[wordsPerRow - 1] |= ~lastWordMask | (1ull << ((width - 1) % 64));
+    }
+}
\ No newline at end of file
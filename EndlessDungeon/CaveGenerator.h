@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+enum class CellType;
+
+// Organic caves from random noise smoothed with the 4-5 cellular automaton rule:
+// a cell ends up a wall when at least 5 cells of its 3x3 block are walls.
+// The grid is bit-packed, one bit per cell and 1 for walls, so a smoothing
+// step updates 64 cells per word with bitwise adders.
+class CaveGenerator
+{
+public:
+    CaveGenerator(int width, int height, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Fill, smooth, then keep only the largest cave so every floor cell is reachable
+    void generate(uint64_t seed, int steps = SMOOTHING_STEPS);
+
+    void fill(uint64_t seed);
+    void smooth();
+    int keep_largest_cave();
+
+    bool is_wall(int x, int y) const;
+    int floor_count() const;
+    void write(std::pmr::vector<CellType>& mapData) const;   // Row-major, width cells per row
+
+    static constexpr int SMOOTHING_STEPS = 5;
+
+private:
+    void sealBorder();
+    uint64_t runStarts(int y, int word) const;
+
+    int width;
+    int height;
+    int wordsPerRow;
+    uint64_t lastWordMask;          // Bits of the last word in a row that are inside the map
+    std::pmr::vector<uint64_t> cells;
+    std::pmr::vector<uint64_t> next;     // Double buffer for smoothing
+    std::pmr::vector<uint64_t> sumLow;   // Per-cell horizontal 3-sums, bit-sliced
+    std::pmr::vector<uint64_t> sumHigh;
+};
@@ -1,11 +1,141 @@
+#include "Benchmarks.h"
 #include "Game.h"
+#include "MapConfig.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
 // Inspiration taken from https://www.raylib.com/examples.html
 
-int main()
+namespace
 {
-    Game game(1900, 900);
+    // Every bad command line ends up here, so the user always gets told what's accepted
+    int badArguments(const std::string& message)
+    {
+        printf("%s\n", message.c_str());
+        printf("Usage: EndlessDungeon [--headless] [--record <file> | --replay <file>] [--frames <count>]\n"
+               "                      [--style rooms|caves] [--config <file>] [--map key=value]...\n"
+               "       EndlessDungeon --bench <name>\n");
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // --bench <name> runs a benchmark without opening the game
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        if (argc != 3) { return badArguments("--bench takes a benchmark name"); }
+        return RunBenchmark(argv[2]);
+    }
+
+    // --headless runs the whole loop on the null platform, for machines without a display,
+    // --record <file> saves the session's input, --replay <file> plays one back and prints frame timings,
+    // --frames <count> stops after that many frames, --style rooms|caves picks the map generator,
+    // --config <file> loads map settings and --map key=value overrides one of them, e.g. --map width=64
+    bool headless = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int frameLimit = -1;
+    MapStyle style = MapStyle::ROOMS;
+    MapConfig mapConfig;
+    std::string error;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* option = argv[i];
+        if (strcmp(option, "--headless") == 0)
+        {
+            headless = true;
+            continue;
+        }
+
+        if (strcmp(option, "--record") != 0 && strcmp(option, "--replay") != 0 && strcmp(option, "--frames") != 0 &&
+            strcmp(option, "--style") != 0 && strcmp(option, "--config") != 0 && strcmp(option, "--map") != 0)
+        {
+            return badArguments(std::string("Unknown option ") + option);
+        }
+        if (i + 1 == argc)
+        {
+            return badArguments(std::string(option) + " needs a value");
+        }
+
+        const char* value = argv[++i];
+        if (strcmp(option, "--record") == 0)
+        {
+            recordPath = value;
+        }
+        else if (strcmp(option, "--replay") == 0)
+        {
+            replayPath = value;
+        }
+        else if (strcmp(option, "--frames") == 0)
+        {
+            char* end = nullptr;
+            const long frames = strtol(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || frames < 0 || frames > INT_MAX)
+            {
+                return badArguments(std::string("Bad frame count ") + value);
+            }
+            frameLimit = static_cast<int>(frames);
+        }
+        else if (strcmp(option, "--style") == 0)
+        {
+            if (strcmp(value, "rooms") == 0) { style = MapStyle::ROOMS; }
+            else if (strcmp(value, "caves") == 0) { style = MapStyle::CAVES; }
+            else { return badArguments(std::string("Unknown map style ") + value); }
+        }
+        else if (strcmp(option, "--config") == 0)
+        {
+            if (!mapConfig.load(value, error))
+            {
+                return badArguments("Bad map config: " + error);
+            }
+        }
+        else if (strcmp(option, "--map") == 0)
+        {
+            const std::string setting = value;
+            const size_t equals = setting.find('=');
+            if (equals == std::string::npos || !mapConfig.set(setting.substr(0, equals), setting.substr(equals + 1), error))
+            {
+                return badArguments("Bad map setting '" + setting + "': " + (equals == std::string::npos ? "expected key=value" : error));
+            }
+        }
+    }
+
+    // Recording opens its file for writing first, so the pair would wipe the file being replayed
+    if (recordPath && replayPath)
+    {
+        return badArguments("--record and --replay can't be used together");
+    }
+
+    if (!mapConfig.validate(style, error))
+    {
+        return badArguments("Bad map config: " + error);
+    }
+
+    // Arguments are all good, only now open the window
+    Game game(1900, 900, headless);
+    if (recordPath && !game.Record(recordPath))
+    {
+        printf("Can't record to %s\n", recordPath);
+        return 1;
+    }
+    if (replayPath && !game.Replay(replayPath))
+    {
+        printf("Can't replay %s\n", replayPath);
+        return 1;
+    }
+    game.SetMapStyle(style);
+    game.SetMapConfig(mapConfig);
+
+    // A headless run without a replay has nothing to end it, give it a soak length
+    if (frameLimit < 0)
+    {
+        frameLimit = headless && !replayPath ? 10000 : 0;
+    }
+    game.SetFrameLimit(frameLimit);
     game.Initialize();
-    game.Run();
-    return 0;
+    return game.Run() ? 0 : 1;
 }
\ No newline at end of file
@@ -1,54 +1,218 @@
 #include "Game.h"
+#include "AllocationCounter.h"
+#include "NullPlatform.h"
+#include "RaylibPlatform.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
 
-Game::Game(int width, int height) : cameraController(map), screenWidth(width), screenHeight(height)
+Game::Game(int width, int height, bool headlessRun) :
+    platform(headlessRun ? std::unique_ptr<Platform>(new NullPlatform()) : std::unique_ptr<Platform>(new RaylibPlatform())),
+    input(*platform),
+    cameraController(map, input),
+    map(*platform),
+    weapon(*platform),
+    screenWidth(width),
+    screenHeight(height),
+    headless(headlessRun),
+    frameLimit(0),
+    levelFailed(false),
+    cullCamera(),
+    cullAspect(1.0f)
 {
-    InitWindow(screenWidth, screenHeight, "Endless Dungeon");
-    DisableCursor();
-    SetTargetFPS(60);
+    platform->InitWindow(screenWidth, screenHeight, "Endless Dungeon");
+    platform->DisableCursor();
+    platform->SetTargetFPS(60);
+}
+
+bool Game::Record(const char* path)
+{
+    return input.start_recording(path);
+}
+
+bool Game::Replay(const char* path)
+{
+    if (!input.start_replay(path)) { return false; }
+
+    // Replays run as fast as the machine allows
+    platform->SetTargetFPS(0);
+    return true;
+}
+
+void Game::SetMapStyle(MapStyle style)
+{
+    // A replay keeps the style it was recorded with
+    if (!input.is_replaying())
+    {
+        input.set_map_style(static_cast<unsigned int>(style));
+    }
+}
+
+void Game::SetMapConfig(const MapConfig& config)
+{
+    // Likewise the map size and room settings
+    if (!input.is_replaying())
+    {
+        input.set_map_config(config);
+    }
 }
 
 void Game::Initialize()
 {
-    map.generate();
-    cameraController.initialize();
+    // A replay brings its own seed so it walks the same dungeon
+    if (!input.is_replaying())
+    {
+        input.set_seed(static_cast<unsigned>(time(nullptr)));
+    }
+    map.set_seed(input.get_seed());
+    map.set_style(static_cast<MapStyle>(input.get_map_style()));
+    map.set_config(input.get_map_config());
+
+    GenerateLevel();
     weapon.Initialize();
 }
 
-void Game::Run()
+bool Game::Run()
 {
-    while (!WindowShouldClose())
+    const bool timeFrames = headless || input.is_replaying();
+    if (timeFrames && frameLimit > 0) { frameTimes.reserve(frameLimit); }
+
+    int frames = 0;
+    while (!levelFailed && !platform->WindowShouldClose() && !input.is_replay_finished() && (frameLimit == 0 || frames < frameLimit))
     {
+        double frameStart = platform->GetTime();
+        frameArena.reset();
+        const long long heapBefore = HeapAllocationCount();
+        const int levelsBefore = allocationStats.levels;
+
+        input.poll();
         Update();
         Draw();
+        frames++;
+
+        // The first frame still warms up containers and the frame arena
+        const int heapAllocations = static_cast<int>(HeapAllocationCount() - heapBefore);
+        if (frames > 1 && allocationStats.levels == levelsBefore)
+        {
+            allocationStats.frames++;
+            allocationStats.frameArenaAllocations += frameArena.allocation_count();
+            allocationStats.frameHeapAllocations += heapAllocations;
+            allocationStats.maxFrameHeapAllocations = std::max(allocationStats.maxFrameHeapAllocations, heapAllocations);
+            if (heapAllocations > 0) { allocationStats.framesWithHeapAllocations++; }
+        }
+
+        if (timeFrames)
+        {
+            frameTimes.push_back(platform->GetTime() - frameStart);
+        }
     }
-    CloseWindow();
+
+    if (timeFrames)
+    {
+        PrintFrameTimings();
+        PrintAllocationStats();
+        platform->PrintStats(frames);
+    }
+    input.finish();
+    platform->CloseWindow();
+    return !levelFailed;
+}
+
+bool Game::GenerateLevel()
+{
+    const long long heapBefore = HeapAllocationCount();
+    if (!map.generate())
+    {
+        // A solid level has nowhere to stand, stop rather than play it
+        printf("Couldn't generate a level with these map settings, try fewer rooms or a bigger map\n");
+        levelFailed = true;
+        return false;
+    }
+    cameraController.initialize();
+
+    const Arena& levelArena = map.get_level_arena();
+    allocationStats.levels++;
+    allocationStats.levelArenaAllocations = levelArena.allocation_count();
+    allocationStats.levelArenaBytes = levelArena.bytes_used();
+    allocationStats.levelArenaBlocks = levelArena.block_allocation_count();
+    allocationStats.levelHeapAllocations = HeapAllocationCount() - heapBefore;
+    return true;
 }
 
 void Game::Update()
 {
-    if (IsKeyPressed(KEY_SPACE))
+    if (input.is_key_pressed(KEY_SPACE) && !GenerateLevel())
     {
-        map.generate();
-        cameraController.initialize();
+        return;
     }
     
     cameraController.update();
-    weapon.Update();
+    weapon.Update(input);
 }
 
 void Game::Draw()
 {
-    BeginDrawing();
-    ClearBackground(BLACK);
+    // The cull job reads this frame's snapshot, a closure holding the whole camera wouldn't fit
+    // in std::function's inline storage and would allocate every frame
+    cullCamera = cameraController.GetCamera();
+    cullAspect = static_cast<float>(platform->GetScreenWidth()) / static_cast<float>(platform->GetScreenHeight());
+    const Camera& camera = cullCamera;
+    const Vector2 playerPos = { camera.position.x, camera.position.z };
+
+    // Visibility runs on the workers while the main thread starts the frame
+    JobHandle culling = jobs.schedule([this] { map.cull(cullCamera, cullAspect); });
+    JobHandle fogOfWar = jobs.schedule([this, playerPos] { map.update_visibility(playerPos); });
+
+    platform->BeginDrawing();
+    platform->ClearBackground(BLACK);
     
-    BeginMode3D(cameraController.GetCamera());
+    jobs.wait(culling);
+    platform->BeginMode3D(camera);
     map.draw();
-    EndMode3D();
+    platform->EndMode3D();
 
     weapon.Draw();
     
-    Vector2 playerPos = { cameraController.GetCamera().position.x,cameraController.GetCamera().position.z };
-    map.draw_minimap(playerPos);
-    
-    EndDrawing();
+    jobs.wait(fogOfWar);
+    map.draw_minimap(playerPos, frameArena);
+
+    // Nothing scheduled this frame may outlive it
+    jobs.sync();
+    platform->EndDrawing();
+}
+
+void Game::PrintFrameTimings() const
+{
+    if (frameTimes.empty()) { return; }
+
+    std::vector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double frameTime : frameTimes) { total += frameTime; }
+
+    auto percentile = [&sorted](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))] * 1000.0; };
+
+    printf("Run: %zu frames in %.3f s (%.1f fps)\n", frameTimes.size(), total, frameTimes.size() / total);
+    printf("Frame ms: avg %.3f  min %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+        total * 1000.0 / frameTimes.size(), sorted.front() * 1000.0,
+        percentile(0.50), percentile(0.95), percentile(0.99), sorted.back() * 1000.0);
+}
+
+void Game::PrintAllocationStats() const
+{
+    const AllocationStats& stats = allocationStats;
+    printf("Level: %d generated, last took %d arena allocations (%.1f KB, %d new blocks)",
+        stats.levels, stats.levelArenaAllocations, stats.levelArenaBytes / 1024.0, stats.levelArenaBlocks);
+    if (HEAP_ALLOCATIONS_COUNTED) { printf(" and %lld heap allocations", stats.levelHeapAllocations); }
+    printf("\n");
+    if (stats.frames == 0) { return; }
+
+    printf("Frame: %.1f scratch allocations", static_cast<double>(stats.frameArenaAllocations) / stats.frames);
+    if (HEAP_ALLOCATIONS_COUNTED)
+    {
+        printf(", %.2f heap allocations (max %d, in %d of %d frames)",
+            static_cast<double>(stats.frameHeapAllocations) / stats.frames,
+            stats.maxFrameHeapAllocations, stats.framesWithHeapAllocations, stats.frames);
+    }
+    printf("\n");
 }
\ No newline at end of file
@@ -1,23 +1,63 @@
 #pragma once
+#include "Arena.h"
 #include "Camera.h"
+#include "Input.h"
+#include "JobSystem.h"
 #include "Map.h"
+#include "Platform.h"
 #include "weapon.h"
+#include <memory>
+#include <vector>
 
 class Game
 {
 public:
-    Game(int screenWidth, int screenHeight);
+    // Headless runs use the null platform: no window, GPU or audio
+    Game(int screenWidth, int screenHeight, bool headless);
+    bool Record(const char* path);
+    bool Replay(const char* path);
+    void SetFrameLimit(int frames) { frameLimit = frames; }
+    void SetMapStyle(MapStyle style);
+    void SetMapConfig(const MapConfig& config);
     void Initialize();
-    void Run();
+    bool Run();     // False when a level couldn't be generated with the map settings
     
 private:
+    bool GenerateLevel();
     void Update();
     void Draw();
+    void PrintFrameTimings() const;
+    void PrintAllocationStats() const;
 
+    // Counters for the end of run report, frames that generate a level are left out
+    struct AllocationStats {
+        int levels = 0;
+        int levelArenaAllocations = 0;      // Of the last level
+        size_t levelArenaBytes = 0;
+        int levelArenaBlocks = 0;
+        long long levelHeapAllocations = 0;
+        int frames = 0;
+        long long frameArenaAllocations = 0;
+        long long frameHeapAllocations = 0;
+        int maxFrameHeapAllocations = 0;
+        int framesWithHeapAllocations = 0;
+    };
+
+    std::unique_ptr<Platform> platform;
+    Input input;
+    JobSystem jobs;
     CameraController cameraController;
     Map map;
     Weapon weapon;
     int screenWidth;
     int screenHeight;
+    bool headless;
+    int frameLimit;
+    bool levelFailed;
+    Camera cullCamera;      // Written before the cull job is scheduled, read only by it until the wait
+    float cullAspect;
+    std::vector<double> frameTimes;
+    Arena frameArena;   // Scratch memory for one frame, rewound at the start of the next
+    AllocationStats allocationStats;
     static constexpr float PLAYER_RADIUS = 0.1f;
 };
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "Input.h"
+#include <cstring>
+#include <fstream>
+
+// Bound to references and indexed at run time, so these need a definition of their own
+constexpr char Input::FILE_MAGIC[4];
+constexpr uint32_t Input::FILE_VERSION;
+constexpr int Input::TRACKED_KEYS[];
+constexpr int Input::TRACKED_BUTTONS[];
+
+namespace
+{
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readMapConfig(std::ifstream& file, uint32_t style, MapConfig& config)
+    {
+        int32_t values[6];
+        if (!readValue(file, values)) { return false; }
+
+        config.width = values[0];
+        config.height = values[1];
+        config.minRoomSize = values[2];
+        config.maxRoomSize = values[3];
+        config.maxRooms = values[4];
+        config.minRooms = values[5];
+        std::string error;
+        return style <= static_cast<uint32_t>(MapStyle::CAVES) && config.validate(static_cast<MapStyle>(style), error);
+    }
+}
+
+Input::Input(Platform& platformRef) : platform(platformRef), mode(Mode::LIVE), seed(0), mapStyle(0), current(), nextFrame(0)
+{
+}
+
+bool Input::start_recording(const char* recordPath)
+{
+    // Fail early rather than after the session when the file can't be written
+    std::ofstream file(recordPath, std::ios::binary);
+    if (!file) { return false; }
+
+    mode = Mode::RECORD;
+    path = recordPath;
+    frames.clear();
+    return true;
+}
+
+bool Input::start_replay(const char* replayPath)
+{
+    std::ifstream file(replayPath, std::ios::binary);
+    if (!file) { return false; }
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t fileSeed = 0;
+    uint32_t fileMapStyle = 0;
+    MapConfig fileMapConfig;    // Older files were all recorded on the default map
+    uint32_t frameCount = 0;
+    if (!readValue(file, magic) || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+        !readValue(file, version) || version < 1 || version > FILE_VERSION ||
+        !readValue(file, fileSeed) || (version >= 2 && !readValue(file, fileMapStyle)) ||
+        (version >= 3 && !readMapConfig(file, fileMapStyle, fileMapConfig)) ||
+        !readValue(file, frameCount))
+    {
+        return false;
+    }
+
+    frames.resize(frameCount);
+    for (InputFrame& frame : frames)
+    {
+        if (!readValue(file, frame.keysDown) || !readValue(file, frame.keysPressed) ||
+            !readValue(file, frame.buttonsPressed) || !readValue(file, frame.mouseDelta.x) ||
+            !readValue(file, frame.mouseDelta.y) || !readValue(file, frame.frameTime))
+        {
+            frames.clear();
+            return false;
+        }
+    }
+
+    mode = Mode::REPLAY;
+    seed = fileSeed;
+    mapStyle = fileMapStyle;
+    mapConfig = fileMapConfig;
+    nextFrame = 0;
+    return true;
+}
+
+void Input::finish()
+{
+    if (mode == Mode::RECORD)
+    {
+        if (!save())
+        {
+            TraceLog(LOG_WARNING, "INPUT: Failed to write recording to %s", path.c_str());
+        }
+    }
+    mode = Mode::LIVE;
+}
+
+bool Input::save() const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) { return false; }
+
+    writeValue(file, FILE_MAGIC);
+    writeValue(file, FILE_VERSION);
+    writeValue(file, static_cast<uint32_t>(seed));
+    writeValue(file, static_cast<uint32_t>(mapStyle));
+    writeValue(file, static_cast<int32_t>(mapConfig.width));
+    writeValue(file, static_cast<int32_t>(mapConfig.height));
+    writeValue(file, static_cast<int32_t>(mapConfig.minRoomSize));
+    writeValue(file, static_cast<int32_t>(mapConfig.maxRoomSize));
+    writeValue(file, static_cast<int32_t>(mapConfig.maxRooms));
+    writeValue(file, static_cast<int32_t>(mapConfig.minRooms));
+    writeValue(file, static_cast<uint32_t>(frames.size()));
+    for (const InputFrame& frame : frames)
+    {
+        // Field by field so the file layout doesn't depend on struct padding
+        writeValue(file, frame.keysDown);
+        writeValue(file, frame.keysPressed);
+        writeValue(file, frame.buttonsPressed);
+        writeValue(file, frame.mouseDelta.x);
+        writeValue(file, frame.mouseDelta.y);
+        writeValue(file, frame.frameTime);
+    }
+    return static_cast<bool>(file);
+}
+
+void Input::poll()
+{
+    if (mode == Mode::REPLAY)
+    {
+        current = nextFrame < frames.size() ? frames[nextFrame++] : InputFrame{};
+        return;
+    }
+
+    current = InputFrame{};
+    for (int i = 0; i < static_cast<int>(sizeof(TRACKED_KEYS) / sizeof(TRACKED_KEYS[0])); i++)
+    {
+        if (platform.IsKeyDown(TRACKED_KEYS[i])) current.keysDown |= 1 << i;
+        if (platform.IsKeyPressed(TRACKED_KEYS[i])) current.keysPressed |= 1 << i;
+    }
+    for (int i = 0; i < static_cast<int>(sizeof(TRACKED_BUTTONS) / sizeof(TRACKED_BUTTONS[0])); i++)
+    {
+        if (platform.IsMouseButtonPressed(TRACKED_BUTTONS[i])) current.buttonsPressed |= 1 << i;
+    }
+    current.mouseDelta = platform.GetMouseDelta();
+    current.frameTime = platform.GetFrameTime();
+
+    if (mode == Mode::RECORD)
+    {
+        frames.push_back(current);
+    }
+}
+
+int Input::keyBit(int key)
+{
+    for (int i = 0; i < static_cast<int>(sizeof(TRACKED_KEYS) / sizeof(TRACKED_KEYS[0])); i++)
+    {
+        if (TRACKED_KEYS[i] == key) { return 1 << i; }
+    }
+    return 0;
+}
+
+int Input::buttonBit(int button)
+{
+    for (int i = 0; i < static_cast<int>(sizeof(TRACKED_BUTTONS) / sizeof(TRACKED_BUTTONS[0])); i++)
+    {
+        if (TRACKED_BUTTONS[i] == button) { return 1 << i; }
+    }
+    return 0;
+}
+
+bool Input::is_key_down(int key) const
+{
+    return (current.keysDown & keyBit(key)) != 0;
+}
+
+bool Input::is_key_pressed(int key) const
+{
+    return (current.keysPressed & keyBit(key)) != 0;
+}
+
+bool Input::is_mouse_button_pressed(int button) const
+{
+    return (current.buttonsPressed & buttonBit(button)) != 0;
+}
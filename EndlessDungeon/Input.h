@@ -0,0 +1,73 @@
+#pragma once
+#include "raylib.h"
+#include "MapConfig.h"
+#include "Platform.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything the game reads from the player in one tick
+struct InputFrame {
+    uint8_t keysDown;       // Bit per entry in TRACKED_KEYS
+    uint8_t keysPressed;
+    uint8_t buttonsPressed; // Bit per entry in TRACKED_BUTTONS
+    Vector2 mouseDelta;
+    float frameTime;
+};
+
+// Gameplay reads input through this instead of raylib so a session can be
+// recorded to a file and replayed tick for tick with the same map seed, style and config.
+class Input
+{
+public:
+    Input(Platform& platformRef);
+
+    bool start_recording(const char* path);
+    bool start_replay(const char* path);
+    void finish();
+
+    // Latches the next tick, from the platform when live or recording, from the file when replaying
+    void poll();
+
+    bool is_key_down(int key) const;
+    bool is_key_pressed(int key) const;
+    bool is_mouse_button_pressed(int button) const;
+    Vector2 get_mouse_delta() const { return current.mouseDelta; }
+    float get_frame_time() const { return current.frameTime; }
+
+    bool is_replaying() const { return mode == Mode::REPLAY; }
+    bool is_replay_finished() const { return mode == Mode::REPLAY && nextFrame >= frames.size(); }
+
+    unsigned int get_seed() const { return seed; }
+    void set_seed(unsigned int newSeed) { seed = newSeed; }
+    unsigned int get_map_style() const { return mapStyle; }
+    void set_map_style(unsigned int newStyle) { mapStyle = newStyle; }
+    const MapConfig& get_map_config() const { return mapConfig; }
+    void set_map_config(const MapConfig& newConfig) { mapConfig = newConfig; }
+
+private:
+    enum class Mode {
+        LIVE,
+        RECORD,
+        REPLAY
+    };
+
+    static int keyBit(int key);
+    static int buttonBit(int button);
+    bool save() const;
+
+    static constexpr char FILE_MAGIC[4] = { 'E', 'D', 'I', 'R' };
+    static constexpr uint32_t FILE_VERSION = 3;   // 2 added the map style, 3 the map config
+    static constexpr int TRACKED_KEYS[] = { KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, KEY_R };
+    static constexpr int TRACKED_BUTTONS[] = { MOUSE_BUTTON_LEFT };
+
+    Platform& platform;
+    Mode mode;
+    std::string path;
+    unsigned int seed;
+    unsigned int mapStyle;
+    MapConfig mapConfig;
+    InputFrame current;
+    std::vector<InputFrame> frames;
+    size_t nextFrame;
+};
@@ -0,0 +1,257 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace
+{
+    // Queue of the current thread, set for workers when they start
+    thread_local const JobSystem* queueOwner = nullptr;
+    thread_local unsigned int queueIndex = 0;
+}
+
+JobSystem::JobSystem(int workerCount) : jobs(new Job[MAX_JOBS_PER_FRAME])
+{
+    if (workerCount < 0)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? static_cast<int>(cores) - 1 : 0;
+    }
+
+    queueCount = static_cast<unsigned int>(workerCount) + 1;
+    queues.reset(new WorkQueue[queueCount]);
+    for (unsigned int i = 1; i < queueCount; i++)
+    {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    sync();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+JobHandle JobSystem::schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies)
+{
+    const JobHandle handle = nextJob.fetch_add(1);
+    if (handle >= MAX_JOBS_PER_FRAME)
+    {
+        // Pool is used up until the next sync, keep going serially
+        for (JobHandle dependency : dependencies)
+        {
+            wait(dependency);
+        }
+        work();
+        return NO_JOB;
+    }
+
+    Job& job = jobs[handle];
+    job.work = std::move(work);
+    unfinishedJobs++;
+
+    // Hold one count ourselves so the job can't start while dependencies are still being added
+    job.pendingDependencies = 1;
+    for (JobHandle dependency : dependencies)
+    {
+        if (dependency == NO_JOB)
+            continue;
+
+        Job& before = jobs[dependency];
+        std::lock_guard<std::mutex> lock(before.mutex);
+        if (!before.finished)
+        {
+            before.dependents.push_back(handle);
+            job.dependencies.push_back(dependency);
+            job.pendingDependencies++;
+        }
+    }
+
+    if (--job.pendingDependencies == 0)
+    {
+        enqueue(handle);
+    }
+    return handle;
+}
+
+void JobSystem::wait(JobHandle job)
+{
+    if (job == NO_JOB) { return; }
+
+    while (!jobs[job].finished)
+    {
+        if (!runFromChain(job))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::sync()
+{
+    while (unfinishedJobs > 0)
+    {
+        if (!runOne(currentQueue()))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Everything has run, the pool can be handed out again
+    const int used = std::min(nextJob.load(), MAX_JOBS_PER_FRAME);
+    for (int i = 0; i < used; i++)
+    {
+        jobs[i].work = nullptr;
+        jobs[i].finished = false;
+        jobs[i].dependents.clear();
+        jobs[i].dependencies.clear();
+    }
+    nextJob = 0;
+}
+
+void JobSystem::workerLoop(unsigned int index)
+{
+    queueOwner = this;
+    queueIndex = index;
+
+    while (running)
+    {
+        if (runOne(index))
+            continue;
+
+        // Nothing to run or steal, sleep until something is queued
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return queuedJobs > 0 || !running; });
+    }
+}
+
+bool JobSystem::runOne(unsigned int index)
+{
+    JobHandle job;
+    if (!popOrSteal(index, job)) { return false; }
+
+    execute(job);
+    return true;
+}
+
+bool JobSystem::runFromChain(JobHandle job)
+{
+    // The job itself if it's queued, otherwise whatever it's still waiting on
+    if (take(job))
+    {
+        execute(job);
+        return true;
+    }
+    for (JobHandle dependency : jobs[job].dependencies)
+    {
+        if (!jobs[dependency].finished && runFromChain(dependency)) { return true; }
+    }
+    return false;
+}
+
+bool JobSystem::take(JobHandle job)
+{
+    for (unsigned int i = 0; i < queueCount; i++)
+    {
+        WorkQueue& queue = queues[i];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (int slot = 0; slot < queue.count; slot++)
+        {
+            if (queue.jobs[(queue.first + slot) % MAX_JOBS_PER_FRAME] != job)
+                continue;
+
+            // Close the gap, keeping the rest in order
+            for (; slot + 1 < queue.count; slot++)
+            {
+                queue.jobs[(queue.first + slot) % MAX_JOBS_PER_FRAME] = queue.jobs[(queue.first + slot + 1) % MAX_JOBS_PER_FRAME];
+            }
+            queue.count--;
+            queuedJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::popOrSteal(unsigned int index, JobHandle& job)
+{
+    // Newest from our own queue while it's still warm in cache
+    {
+        WorkQueue& own = queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0)
+        {
+            own.count--;
+            job = own.jobs[(own.first + own.count) % MAX_JOBS_PER_FRAME];
+            queuedJobs--;
+            return true;
+        }
+    }
+
+    // Oldest from someone else's, those tend to be the bigger pieces of work
+    for (unsigned int offset = 1; offset < queueCount; offset++)
+    {
+        WorkQueue& victim = queues[(index + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count > 0)
+        {
+            job = victim.jobs[victim.first];
+            victim.first = (victim.first + 1) % MAX_JOBS_PER_FRAME;
+            victim.count--;
+            queuedJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::enqueue(JobHandle job)
+{
+    {
+        WorkQueue& queue = queues[currentQueue()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs[(queue.first + queue.count) % MAX_JOBS_PER_FRAME] = job;
+        queue.count++;
+        queuedJobs++;
+    }
+
+    // Taking the sleep lock orders this with a worker about to go to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+void JobSystem::execute(JobHandle job)
+{
+    jobs[job].work();
+    release(job);
+}
+
+void JobSystem::release(JobHandle job)
+{
+    Job& finishedJob = jobs[job];
+    {
+        std::lock_guard<std::mutex> lock(finishedJob.mutex);
+        finishedJob.finished = true;
+        for (JobHandle dependent : finishedJob.dependents)
+        {
+            if (--jobs[dependent].pendingDependencies == 0)
+            {
+                enqueue(dependent);
+            }
+        }
+    }
+    unfinishedJobs--;
+}
+
+unsigned int JobSystem::currentQueue() const
+{
+    return queueOwner == this ? queueIndex : 0;
+}
\ No newline at end of file
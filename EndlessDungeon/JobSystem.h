@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using JobHandle = int;
+
+// Work-stealing scheduler for per-frame work. Every thread owns a queue,
+// runs its own newest job first and steals the oldest from others when idle.
+// Jobs only start once all the jobs they depend on have finished. Handles
+// stay valid until the next sync().
+class JobSystem
+{
+public:
+    // A negative count picks one worker per core, leaving a core for the main thread
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Past MAX_JOBS_PER_FRAME jobs since the last sync() the job runs inline and NO_JOB is returned
+    JobHandle schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies = {});
+
+    // Waits for one job. The calling thread helps with that job and the jobs it depends on,
+    // never with unrelated work that could take longer than the wait itself.
+    void wait(JobHandle job);
+
+    // Frame sync point: waits for every scheduled job and recycles the job pool
+    void sync();
+
+    unsigned int worker_count() const { return static_cast<unsigned int>(workers.size()); }
+
+    static constexpr int MAX_JOBS_PER_FRAME = 4096;
+    static constexpr JobHandle NO_JOB = -1;
+
+private:
+    struct Job {
+        std::function<void()> work;
+        std::atomic<int> pendingDependencies{ 0 };
+        std::mutex mutex;               // Guards finished and dependents
+        std::atomic<bool> finished{ false };
+        std::vector<JobHandle> dependents;
+        std::vector<JobHandle> dependencies;    // Unfinished when scheduled, for wait()
+    };
+
+    // Ring of job handles, a frame never queues more than MAX_JOBS_PER_FRAME so it never grows
+    struct WorkQueue {
+        std::mutex mutex;
+        std::unique_ptr<JobHandle[]> jobs{ new JobHandle[MAX_JOBS_PER_FRAME] };
+        int first = 0;
+        int count = 0;
+    };
+
+    void workerLoop(unsigned int queueIndex);
+    bool runOne(unsigned int queueIndex);
+    bool runFromChain(JobHandle job);
+    bool take(JobHandle job);
+    bool popOrSteal(unsigned int queueIndex, JobHandle& job);
+    void enqueue(JobHandle job);
+    void execute(JobHandle job);
+    void release(JobHandle job);
+    unsigned int currentQueue() const;
+
+    std::unique_ptr<Job[]> jobs;
+    std::atomic<int> nextJob{ 0 };
+    std::atomic<int> unfinishedJobs{ 0 };
+
+    // Queue 0 belongs to the thread that created the system, one more per worker
+    std::unique_ptr<WorkQueue[]> queues;
+    unsigned int queueCount;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<bool> running{ true };
+};
@@ -1,22 +1,167 @@
 #include "Map.h"
+#include "CaveGenerator.h"
+#include "MapKernels.h"
+#include <raymath.h>
 #include <algorithm>
 #include <cstdlib>
+#include <cmath>
 #include <ctime>
 
-Map::Map() : model(), texture(), position(MAP_POSITION)
+namespace
+{
+    // Regions of cubicmap_atlas.png. Like raylib's GenMeshCubicmap, a wall facing +x or +z
+    // (a cube's right or front face) takes the top-left quarter, one facing -x or -z the top-right.
+    constexpr Rectangle WALL_UV_POSITIVE{ 0.0f, 0.0f, 0.5f, 0.5f };
+    constexpr Rectangle WALL_UV_NEGATIVE{ 0.5f, 0.0f, 0.5f, 0.5f };
+    constexpr Rectangle CEILING_UV{ 0.0f, 0.5f, 0.5f, 0.5f };
+    constexpr Rectangle FLOOR_UV{ 0.5f, 0.5f, 0.5f, 0.5f };
+    constexpr float WALL_HEIGHT = 1.0f;
+
+    // Appends a quad as two triangles, counter-clockwise as seen from the side the normal points to
+    void appendQuad(Mesh& mesh, int& vertex, Vector3 corners[4], const Vector3& normal, const Rectangle& uv)
+    {
+        Vector2 texcoords[4] = {
+            { uv.x, uv.y + uv.height }, { uv.x + uv.width, uv.y + uv.height },
+            { uv.x + uv.width, uv.y }, { uv.x, uv.y }
+        };
+
+        Vector3 facing = Vector3CrossProduct(Vector3Subtract(corners[1], corners[0]), Vector3Subtract(corners[2], corners[0]));
+        if (Vector3DotProduct(facing, normal) < 0.0f)
+        {
+            std::swap(corners[1], corners[3]);
+            std::swap(texcoords[1], texcoords[3]);
+        }
+
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int corner : order)
+        {
+            mesh.vertices[vertex * 3 + 0] = corners[corner].x;
+            mesh.vertices[vertex * 3 + 1] = corners[corner].y;
+            mesh.vertices[vertex * 3 + 2] = corners[corner].z;
+            mesh.normals[vertex * 3 + 0] = normal.x;
+            mesh.normals[vertex * 3 + 1] = normal.y;
+            mesh.normals[vertex * 3 + 2] = normal.z;
+            mesh.texcoords[vertex * 2 + 0] = texcoords[corner].x;
+            mesh.texcoords[vertex * 2 + 1] = texcoords[corner].y;
+            vertex++;
+        }
+    }
+}
+
+Map::Map(Platform& platformRef) :
+    platform(platformRef),
+    cellMeshes(&levelArena),
+    material(),
+    texture(),
+    position(MAP_POSITION),
+    style(MapStyle::ROOMS),
+    config(),
+    kernels(&SelectMapKernels(config.width, config.height)),
+    spawnPoint(),
+    mapData(&levelArena),
+    rooms(&levelArena),
+    portalGraph(&levelArena),
+    visibleCells(&levelArena),
+    objects(&levelArena),
+    visibilityMap(&levelArena),
+    minimapPixels(&levelArena),
+    minimapCellsPerPixel(1),
+    minimapWidth(config.width),
+    minimapHeight(config.height)
 {
     // Initialize the map data
-    mapData.resize(MAP_HEIGHT, std::vector<CellType>(MAP_WIDTH, CellType::WALL));
+    mapData.resize(config.width * config.height, CellType::WALL);
     srand(static_cast<unsigned>(time(nullptr)));
 }
 
 Map::~Map()
 {
-    UnloadTexture(texture);
-    UnloadModel(model);
+    unloadMesh();
+}
+
+void Map::set_seed(unsigned int seed)
+{
+    srand(seed);
+}
+
+void Map::set_style(MapStyle newStyle)
+{
+    style = newStyle;
+}
+
+void Map::set_config(const MapConfig& newConfig)
+{
+    config = newConfig;
+}
+
+bool Map::generate()
+{
+    resetLevel();
+
+    const bool generated = style == MapStyle::CAVES ? generateCaves() : generateRooms();
+
+    // Split the layout into rooms and corridors linked by portals, the mesh is built per cell
+    portalGraph.build(mapData, config.width, config.height, rooms, position);
+    objects.reset(config.width, config.height, position);
+
+    // Culling runs on a worker, it must never grow this and allocate from the arena
+    visibleCells.reserve(portalGraph.cell_count());
+
+    // Generate the 3D mesh from the map data
+    const bool meshed = generateMesh();
+    
+    // Initialize visibility map
+    visibilityMap.resize(config.width * config.height, 0);
+    
+    // Make the spawn room visible initially
+    if (!rooms.empty())
+        {
+        const Room& firstRoom = rooms.front();
+        for (int y = firstRoom.y; y < firstRoom.y + firstRoom.height; y++)
+            {
+            for (int x = firstRoom.x; x < firstRoom.x + firstRoom.width; x++)
+                {
+                visibilityMap[y * config.width + x] = 1;
+            }
+        }
+    }
+
+    // The one full scan of the level for the downsampled minimap
+    if (minimapCellsPerPixel > 1)
+    {
+        minimapPixels.resize(minimapWidth * minimapHeight);
+        updateMinimapPixels(0, 0, config.width - 1, config.height - 1);
+    }
+    return generated && meshed;
+}
+
+void Map::resetLevel()
+{
+    // Drop the GPU side, then every container holding arena memory, then the arena itself
+    unloadMesh();
+    cellMeshes = std::pmr::vector<Mesh>(&levelArena);
+    mapData = std::pmr::vector<CellType>(&levelArena);
+    rooms = std::pmr::vector<Room>(&levelArena);
+    portalGraph = PortalGraph(&levelArena);
+    visibleCells = std::pmr::vector<int>(&levelArena);
+    objects = SpatialGrid(&levelArena);
+    visibilityMap = std::pmr::vector<char>(&levelArena);
+    minimapPixels = std::pmr::vector<Color>(&levelArena);
+    levelArena.reset();
+
+    // The size may have changed since the last level
+    kernels = &SelectMapKernels(config.width, config.height);
+    minimapCellsPerPixel = (std::max(config.width, config.height) + MINIMAP_SIZE - 1) / MINIMAP_SIZE;
+    minimapWidth = (config.width + minimapCellsPerPixel - 1) / minimapCellsPerPixel;
+    minimapHeight = (config.height + minimapCellsPerPixel - 1) / minimapCellsPerPixel;
+    mapData.resize(config.width * config.height, CellType::WALL);
+    if (style == MapStyle::ROOMS)
+    {
+        rooms.reserve(config.maxRooms);
+    }
 }
 
-void Map::generate()
+bool Map::generateRooms()
 {
     int attempts = 0;
     const int MAX_ATTEMPTS = 100;  // Prevent infinite loops
@@ -26,13 +171,13 @@ void Map::generate()
         initializeMap();
         
         // Generate rooms
-        for (int i = 0; i < MAX_ROOMS; i++)
+        for (int i = 0; i < config.maxRooms; i++)
         {
             // Generate random room dimensions and position
-            int width = MIN_ROOM_SIZE + rand() % (MAX_ROOM_SIZE - MIN_ROOM_SIZE + 1);
-            int height = MIN_ROOM_SIZE + rand() % (MAX_ROOM_SIZE - MIN_ROOM_SIZE + 1);
-            int x = rand() % (MAP_WIDTH - width - 2) + 1;
-            int y = rand() % (MAP_HEIGHT - height - 2) + 1;
+            int width = config.minRoomSize + rand() % (config.maxRoomSize - config.minRoomSize + 1);
+            int height = config.minRoomSize + rand() % (config.maxRoomSize - config.minRoomSize + 1);
+            int x = rand() % (config.width - width - 2) + 1;
+            int y = rand() % (config.height - height - 2) + 1;
 
             Room newRoom{x, y, width, height};
 
@@ -68,44 +213,69 @@ void Map::generate()
         
         attempts++;
     }
-    while (rooms.size() < 6 && attempts < MAX_ATTEMPTS);  // Ensure at least 4 rooms
+    while (rooms.size() < static_cast<size_t>(config.minRooms) && attempts < MAX_ATTEMPTS);  // Ensure enough rooms
 
-    if (rooms.size() < 6)
+    if (rooms.size() < static_cast<size_t>(config.minRooms))
         {
         initializeMap();
+        return false;
         }
 
-    // Generate the 3D mesh from the map data
-    generateMesh();
-    
-    // Initialize visibility map
-    visibilityMap = std::vector<std::vector<bool>>(MAP_HEIGHT, std::vector<bool>(MAP_WIDTH, false));
-    
-    // Make the spawn room visible initially
-    if (!rooms.empty())
+    // Spawn in the center of the first room
+    const Room& firstRoom = rooms.front();
+    spawnPoint = Vector2{ firstRoom.x + (firstRoom.width / 2.0f), firstRoom.y + (firstRoom.height / 2.0f) };
+    return true;
+}
+
+bool Map::generateCaves()
+{
+    CaveGenerator caves(config.width, config.height, &levelArena);
+    const int MIN_FLOOR = config.width * config.height / 4;  // Reject caves too small to explore
+    const int MAX_ATTEMPTS = 100;
+    int attempts = 0;
+
+    do
+    {
+        // rand() may only give 15 bits, stretch it over the generator's 64-bit seed
+        uint64_t seed = 0;
+        for (int i = 0; i < 4; i++)
         {
-        const Room& firstRoom = rooms.front();
-        for (int y = firstRoom.y; y < firstRoom.y + firstRoom.height; y++)
+            seed = (seed << 16) ^ static_cast<uint64_t>(rand());
+        }
+        caves.generate(seed);
+        attempts++;
+    }
+    while (caves.floor_count() < MIN_FLOOR && attempts < MAX_ATTEMPTS);
+
+    initializeMap();
+    if (caves.floor_count() == 0) { return false; }
+    caves.write(mapData);
+
+    // Spawn on the floor cell closest to the middle of the map
+    const int centerX = config.width / 2;
+    const int centerY = config.height / 2;
+    int bestDistance = config.width * config.width + config.height * config.height;
+    for (int y = 0; y < config.height; y++)
+    {
+        for (int x = 0; x < config.width; x++)
+        {
+            int distance = (x - centerX) * (x - centerX) + (y - centerY) * (y - centerY);
+            if (mapData[y * config.width + x] == CellType::FLOOR && distance < bestDistance)
             {
-            for (int x = firstRoom.x; x < firstRoom.x + firstRoom.width; x++)
-                {
-                visibilityMap[y][x] = true;
+                bestDistance = distance;
+                spawnPoint = Vector2{ static_cast<float>(x), static_cast<float>(y) };
             }
         }
     }
+    return true;
 }
 
 void Map::initializeMap()
 {
     // Fill the map with walls
-    for (int y = 0; y < MAP_HEIGHT; y++)
-    {
-        for (int x = 0; x < MAP_WIDTH; x++)
-        {
-            mapData[y][x] = CellType::WALL;
-        }
-    }
+    std::fill(mapData.begin(), mapData.end(), CellType::WALL);
     rooms.clear();
+    spawnPoint = Vector2{ 0.0f, 0.0f };
 }
 
 void Map::createRoom(const Room& room)
@@ -114,7 +284,7 @@ void Map::createRoom(const Room& room)
     {
         for (int x = room.x; x < room.x + room.width; x++)
         {
-            mapData[y][x] = CellType::FLOOR;
+            mapData[y * config.width + x] = CellType::FLOOR;
         }
     }
 }
@@ -124,11 +294,11 @@ void Map::createCorridor(int x1, int y1, int x2, int y2)
     // Create a corridor between two points
     for (int x = std::min(x1, x2); x <= std::max(x1, x2); x++)
     {
-        mapData[y1][x] = CellType::FLOOR;
+        mapData[y1 * config.width + x] = CellType::FLOOR;
     }
     for (int y = std::min(y1, y2); y <= std::max(y1, y2); y++)
     {
-        mapData[y][x2] = CellType::FLOOR;
+        mapData[y * config.width + x2] = CellType::FLOOR;
     }
 }
 
@@ -136,8 +306,8 @@ bool Map::isRoomValid(const Room& room) const
 {
     // Check if the room fits within the map with padding
     if (room.x < 1 || room.y < 1 || 
-        room.x + room.width >= MAP_WIDTH - 1 || 
-        room.y + room.height >= MAP_HEIGHT - 1)
+        room.x + room.width >= config.width - 1 || 
+        room.y + room.height >= config.height - 1)
         return false;
 
     // Check if the room overlaps with any existing rooms (including padding)
@@ -145,7 +315,7 @@ bool Map::isRoomValid(const Room& room) const
     {
         for (int x = room.x - 1; x < room.x + room.width + 1; x++)
         {
-            if (mapData[y][x] == CellType::FLOOR)
+            if (mapData[y * config.width + x] == CellType::FLOOR)
                 return false;
         }
     }
@@ -153,146 +323,242 @@ bool Map::isRoomValid(const Room& room) const
     return true;
 }
 
-void Map::generateMesh()
+bool Map::generateMesh()
 {
-    // Create a temporary image for the map
-    Color* mapPixels = createMapPixels();
-    Image imMap = { 0 }; 
-    imMap.data = mapPixels;
-    imMap.width = MAP_WIDTH;
-    imMap.height = MAP_HEIGHT;
-    imMap.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
-    imMap.mipmaps = 1;
-
-    // Generate the 3D mesh
-    Mesh mesh = GenMeshCubicmap(imMap, Vector3{ 1.0f, 1.0f, 1.0f });
-    model = LoadModelFromMesh(mesh);
+    // Every floor tile gets a floor, a ceiling and a wall towards each solid neighbour.
+    // Walls go in the mesh of the cell they face, so a cell owns everything seen from inside it.
+    const int cellCount = portalGraph.cell_count();
+    const int neighbours[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+    std::pmr::vector<int> quadCounts(cellCount, 0, &levelArena);
+    for (int y = 0; y < config.height; y++)
+    {
+        for (int x = 0; x < config.width; x++)
+        {
+            int cell = portalGraph.cell_at(x, y);
+            if (cell < 0)
+                continue;
+
+            quadCounts[cell] += 2;
+            for (const auto& offset : neighbours)
+            {
+                if (isSolid(x + offset[0], y + offset[1])) { quadCounts[cell]++; }
+            }
+        }
+    }
+
+    cellMeshes.assign(cellCount, Mesh{});
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        Mesh& mesh = cellMeshes[cell];
+        mesh.triangleCount = quadCounts[cell] * 2;
+        mesh.vertexCount = quadCounts[cell] * 6;
+        mesh.vertices = (float*)RL_MALLOC(static_cast<size_t>(mesh.vertexCount) * 3 * sizeof(float));
+        mesh.normals = (float*)RL_MALLOC(static_cast<size_t>(mesh.vertexCount) * 3 * sizeof(float));
+        mesh.texcoords = (float*)RL_MALLOC(static_cast<size_t>(mesh.vertexCount) * 2 * sizeof(float));
+        if (!mesh.vertices || !mesh.normals || !mesh.texcoords)
+        {
+            // Leave no half-built meshes behind, the level fails instead of crashing in appendQuad
+            TraceLog(LOG_WARNING, "MAP: Out of memory for a mesh of %d vertices", mesh.vertexCount);
+            unloadMesh();
+            return false;
+        }
+    }
+
+    std::pmr::vector<int> vertexCounts(cellCount, 0, &levelArena);
+    for (int y = 0; y < config.height; y++)
+    {
+        for (int x = 0; x < config.width; x++)
+        {
+            int cell = portalGraph.cell_at(x, y);
+            if (cell < 0)
+                continue;
+
+            Mesh& mesh = cellMeshes[cell];
+            const float left = x - 0.5f, right = x + 0.5f;
+            const float front = y - 0.5f, back = y + 0.5f;
+
+            Vector3 floor[4] = { { left, 0.0f, front }, { right, 0.0f, front }, { right, 0.0f, back }, { left, 0.0f, back } };
+            appendQuad(mesh, vertexCounts[cell], floor, Vector3{ 0.0f, 1.0f, 0.0f }, FLOOR_UV);
+
+            Vector3 ceiling[4] = { { left, WALL_HEIGHT, front }, { right, WALL_HEIGHT, front }, { right, WALL_HEIGHT, back }, { left, WALL_HEIGHT, back } };
+            appendQuad(mesh, vertexCounts[cell], ceiling, Vector3{ 0.0f, -1.0f, 0.0f }, CEILING_UV);
+
+            for (const auto& offset : neighbours)
+            {
+                if (!isSolid(x + offset[0], y + offset[1]))
+                    continue;
+
+                // Wall on the shared edge, bottom corners first so the texture stays upright
+                Vector3 normal{ -static_cast<float>(offset[0]), 0.0f, -static_cast<float>(offset[1]) };
+                const Rectangle& wallUv = normal.x + normal.z > 0.0f ? WALL_UV_POSITIVE : WALL_UV_NEGATIVE;
+                if (offset[0] != 0)
+                {
+                    float edge = x + offset[0] * 0.5f;
+                    Vector3 wall[4] = { { edge, 0.0f, front }, { edge, 0.0f, back }, { edge, WALL_HEIGHT, back }, { edge, WALL_HEIGHT, front } };
+                    appendQuad(mesh, vertexCounts[cell], wall, normal, wallUv);
+                }
+                else
+                {
+                    float edge = y + offset[1] * 0.5f;
+                    Vector3 wall[4] = { { left, 0.0f, edge }, { right, 0.0f, edge }, { right, WALL_HEIGHT, edge }, { left, WALL_HEIGHT, edge } };
+                    appendQuad(mesh, vertexCounts[cell], wall, normal, wallUv);
+                }
+            }
+        }
+    }
+
+    for (Mesh& mesh : cellMeshes)
+    {
+        platform.UploadMesh(&mesh);
+    }
 
     // Load or create the texture for the walls
-    texture = LoadTexture("resources/cubicmap_atlas.png"); 
-    model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+    texture = platform.LoadTexture("resources/cubicmap_atlas.png");
+    material = platform.LoadMaterialDefault();
+    material.maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+    return true;
+}
 
-    // Clean up
-    RL_FREE(mapPixels);
+void Map::unloadMesh()
+{
+    for (Mesh& mesh : cellMeshes)
+    {
+        platform.UnloadMesh(mesh);
+    }
+    cellMeshes.clear();
+
+    // The texture is ours, only the material's map array needs freeing
+    RL_FREE(material.maps);
+    material = Material{};
+    platform.UnloadTexture(texture);
+    texture = Texture2D{};
 }
 
-Color* Map::createMapPixels() const
+bool Map::isSolid(int x, int y) const
 {
-    Color* pixels = (Color*)RL_MALLOC(MAP_WIDTH * MAP_HEIGHT * sizeof(Color));
-    
-    for (int y = 0; y < MAP_HEIGHT; y++)
+    if (x < 0 || x >= config.width || y < 0 || y >= config.height) { return true; }
+    return mapData[y * config.width + x] == CellType::WALL;
+}
+
+void Map::cull(const Camera& camera, float aspect)
+{
+    if (!portalGraph.collect_visible(camera, aspect, visibleCells))
     {
-        for (int x = 0; x < MAP_WIDTH; x++)
+        // Camera isn't inside any room or corridor, draw everything
+        visibleCells.clear();
+        for (int cell = 0; cell < static_cast<int>(cellMeshes.size()); cell++)
         {
-            pixels[y * MAP_WIDTH + x] = (mapData[y][x] == CellType::WALL) ?
-                Color{255, 255, 255, 255} :  // White for walls
-                Color{0, 0, 0, 255};         // Black for floors
+            visibleCells.push_back(cell);
         }
     }
-    
-    return pixels;
 }
 
 void Map::draw()
 {
-    DrawModel(model, position, 1.0f, WHITE);
+    Matrix transform = MatrixTranslate(position.x, position.y, position.z);
+    for (int cell : visibleCells)
+    {
+        if (cellMeshes[cell].vertexCount > 0)
+        {
+            platform.DrawMesh(cellMeshes[cell], material, transform);
+        }
+    }
 }
 
-void Map::updateVisibility(const Vector2& playerPos)
+void Map::update_visibility(const Vector2& playerPos)
 {
     // Convert world position to map coordinates
     int playerCellX = static_cast<int>(playerPos.x - position.x + 0.5f);
     int playerCellY = static_cast<int>(playerPos.y - position.z + 0.5f);
     
     // Update visibility around player
-    for (int y = -VISIBILITY_RADIUS; y <= VISIBILITY_RADIUS; y++)
+    kernels->update_visibility(mapData.data(), visibilityMap.data(), config.width, config.height, playerCellX, playerCellY, VISIBILITY_RADIUS);
+
+    // Only the blocks within reach of the player can have changed
+    if (minimapCellsPerPixel > 1)
+    {
+        const int reach = static_cast<int>(VISIBILITY_RADIUS);
+        updateMinimapPixels(playerCellX - reach, playerCellY - reach, playerCellX + reach, playerCellY + reach);
+    }
+}
+
+void Map::updateMinimapPixels(int minX, int minY, int maxX, int maxY)
+{
+    // A block of cells per pixel. Seen floor beats seen wall so one-cell corridors don't vanish,
+    // anything seen beats fog.
+    const int cellsPerPixel = minimapCellsPerPixel;
+    const int firstPixelX = std::max(0, minX) / cellsPerPixel;
+    const int firstPixelY = std::max(0, minY) / cellsPerPixel;
+    const int lastPixelX = std::min(maxX, config.width - 1) / cellsPerPixel;
+    const int lastPixelY = std::min(maxY, config.height - 1) / cellsPerPixel;
+    for (int pixelY = firstPixelY; pixelY <= lastPixelY; pixelY++)
     {
-        for (int x = -VISIBILITY_RADIUS; x <= VISIBILITY_RADIUS; x++)
+        const int endY = std::min((pixelY + 1) * cellsPerPixel, config.height);
+        for (int pixelX = firstPixelX; pixelX <= lastPixelX; pixelX++)
         {
-            int checkX = playerCellX + x;
-            int checkY = playerCellY + y;
-            
-            // Check if within map bounds
-            if (checkX >= 0 && checkX < MAP_WIDTH && 
-                checkY >= 0 && checkY < MAP_HEIGHT)
+            const int endX = std::min((pixelX + 1) * cellsPerPixel, config.width);
+            bool seenFloor = false;
+            bool seenWall = false;
+            for (int y = pixelY * cellsPerPixel; y < endY && !seenFloor; y++)
             {
-                
-                // Check if within visibility radius
-                float distance = sqrtf(x*x + y*y);
-                if (distance <= VISIBILITY_RADIUS)
+                for (int x = pixelX * cellsPerPixel; x < endX; x++)
                 {
-                    // Simple line of sight check
-                    bool hasLineOfSight = true;
-                    float dx = static_cast<float>(x);
-                    float dy = static_cast<float>(y);
-                    float steps = distance * 2;
-                    
-                    for (float i = 0; i < steps; i++)
-                    {
-                        int checkStepX = playerCellX + static_cast<int>(dx * (i / steps));
-                        int checkStepY = playerCellY + static_cast<int>(dy * (i / steps));
-                        
-                        if (mapData[checkStepY][checkStepX] == CellType::WALL)
-                        {
-                            hasLineOfSight = false;
-                            break;
-                        }
-                    }
-                    
-                    if (hasLineOfSight)
+                    const int cell = y * config.width + x;
+                    if (!visibilityMap[cell])
+                        continue;
+
+                    if (mapData[cell] != CellType::WALL)
                     {
-                        visibilityMap[checkY][checkX] = true;
+                        seenFloor = true;
+                        break;
                     }
+                    seenWall = true;
                 }
             }
+            minimapPixels[pixelY * minimapWidth + pixelX] = seenFloor ? BLACK : (seenWall ? WHITE : DARKGRAY);
         }
     }
 }
 
-void Map::draw_minimap(const Vector2& playerPosition)
+void Map::draw_minimap(const Vector2& playerPosition, std::pmr::memory_resource& scratch)
 {
-    const int MINIMAP_SCALE = 4;
-    Vector2 minimapPos = { static_cast<float>(GetScreenWidth() - MAP_WIDTH * MINIMAP_SCALE - 20), 20.0f };
+    // 4 pixels per cell on the original 32x32 map and no more than MINIMAP_SIZE pixels across
+    // on any map: up to 128 cells it scales down, past that several cells share a pixel
+    const int cellsPerPixel = minimapCellsPerPixel;
+    const int MINIMAP_SCALE = std::max(1, MINIMAP_SIZE / std::max(config.width, config.height));
+    Vector2 minimapPos = { static_cast<float>(platform.GetScreenWidth() - minimapWidth * MINIMAP_SCALE - 20), 20.0f };
     
-    // Update visibility before drawing
-    updateVisibility(playerPosition);
-    
-    // Draw the minimap background
-    for (int y = 0; y < MAP_HEIGHT; y++)
+    // Draw the minimap background. Full-size maps are small enough for the kernel to redo
+    // every frame, downsampled ones keep their pixels from update_visibility.
+    std::pmr::vector<Color> framePixels(&scratch);
+    const Color* pixels = minimapPixels.data();
+    if (cellsPerPixel == 1)
+    {
+        framePixels.resize(minimapWidth * minimapHeight);
+        kernels->create_map_pixels(mapData.data(), visibilityMap.data(), config.width, config.height, framePixels.data());
+        pixels = framePixels.data();
+    }
+    for (int y = 0; y < minimapHeight; y++)
     {
-        for (int x = 0; x < MAP_WIDTH; x++)
+        for (int x = 0; x < minimapWidth; x++)
         {
-            if (visibilityMap[y][x])
-            {
-                Color cellColor = (mapData[y][x] == CellType::WALL) ? WHITE : BLACK;
-                DrawRectangle(
-                    static_cast<int>(minimapPos.x + x * MINIMAP_SCALE),
-                    static_cast<int>(minimapPos.y + y * MINIMAP_SCALE),
-                    MINIMAP_SCALE,
-                    MINIMAP_SCALE,
-                    cellColor
-                );
-            }
-            else
-            {
-                // Draw fog of war
-                DrawRectangle(
-                    static_cast<int>(minimapPos.x + x * MINIMAP_SCALE),
-                    static_cast<int>(minimapPos.y + y * MINIMAP_SCALE),
-                    MINIMAP_SCALE,
-                    MINIMAP_SCALE,
-                    DARKGRAY  // Fog of war color
-                );
-            }
+            platform.DrawRectangle(
+                static_cast<int>(minimapPos.x + x * MINIMAP_SCALE),
+                static_cast<int>(minimapPos.y + y * MINIMAP_SCALE),
+                MINIMAP_SCALE,
+                MINIMAP_SCALE,
+                pixels[y * minimapWidth + x]
+            );
         }
     }
 
     // Draw minimap border
-    DrawRectangleLines(
+    platform.DrawRectangleLines(
         static_cast<int>(minimapPos.x),
         static_cast<int>(minimapPos.y),
-        MAP_WIDTH * MINIMAP_SCALE,
-        MAP_HEIGHT * MINIMAP_SCALE,
+        minimapWidth * MINIMAP_SCALE,
+        minimapHeight * MINIMAP_SCALE,
         GREEN
     );
 
@@ -300,12 +566,12 @@ void Map::draw_minimap(const Vector2& playerPosition)
     int playerCellX = static_cast<int>(playerPosition.x - position.x + 0.5f);
     int playerCellY = static_cast<int>(playerPosition.y - position.z + 0.5f);
     
-    playerCellX = std::max(0, std::min(playerCellX, MAP_WIDTH - 1));
-    playerCellY = std::max(0, std::min(playerCellY, MAP_HEIGHT - 1));
+    playerCellX = std::max(0, std::min(playerCellX, config.width - 1));
+    playerCellY = std::max(0, std::min(playerCellY, config.height - 1));
 
-    DrawRectangle(
-        static_cast<int>(minimapPos.x + playerCellX * MINIMAP_SCALE),
-        static_cast<int>(minimapPos.y + playerCellY * MINIMAP_SCALE),
+    platform.DrawRectangle(
+        static_cast<int>(minimapPos.x + playerCellX / cellsPerPixel * MINIMAP_SCALE),
+        static_cast<int>(minimapPos.y + playerCellY / cellsPerPixel * MINIMAP_SCALE),
         MINIMAP_SCALE,
         MINIMAP_SCALE,
         RED
@@ -314,31 +580,6 @@ void Map::draw_minimap(const Vector2& playerPosition)
 
 bool Map::check_collision(const Vector2& playerPos, float playerRadius)
 {
-    int playerCellX = static_cast<int>(playerPos.x - position.x + 0.5f);
-    int playerCellY = static_cast<int>(playerPos.y - position.z + 0.5f);
-
-    playerCellX = std::max(0, std::min(playerCellX, MAP_WIDTH - 1));
-    playerCellY = std::max(0, std::min(playerCellY, MAP_HEIGHT - 1));
-
-    for (int y = 0; y < MAP_HEIGHT; y++)
-    {
-        for (int x = 0; x < MAP_WIDTH; x++)
-        {
-            if (mapData[y][x] == CellType::WALL)
-            {
-                Rectangle cellBounds{
-                    position.x - 0.5f + x * 1.0f,
-                    position.z - 0.5f + y * 1.0f,
-                    1.0f,
-                    1.0f
-                };
-
-                if (CheckCollisionCircleRec(playerPos, playerRadius, cellBounds))
-                {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    const Vector2 origin{ position.x, position.z };
+    return kernels->check_collision(mapData.data(), config.width, config.height, origin, playerPos, playerRadius);
 }
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 #include "raylib.h"
+#include "Arena.h"
+#include "MapConfig.h"
+#include "Platform.h"
+#include "PortalGraph.h"
+#include "SpatialGrid.h"
+#include <memory_resource>
 #include <vector>
 
 enum class CellType {
@@ -14,62 +20,91 @@ struct Room {
     int height;
 };
 
+struct MapKernelTable;
+
 
 class Map
 {
 public:
-    Map();
+    Map(Platform& platformRef);
     ~Map();
     
-    void generate();
+    void set_seed(unsigned int seed);
+    void set_style(MapStyle newStyle);
+    void set_config(const MapConfig& newConfig);    // Takes effect on the next generate()
+    // False when no playable layout came out of the attempts, the map is then solid wall,
+    // or when there wasn't memory for the level's mesh
+    bool generate();
     void draw();
-    void draw_minimap(const Vector2& playerPosition);
+    void draw_minimap(const Vector2& playerPosition, std::pmr::memory_resource& scratch);
+
+    // Per-frame visibility, safe to run on worker threads alongside each other
+    void cull(const Camera& camera, float aspect);
+    void update_visibility(const Vector2& playerPos);
+
     bool check_collision(const Vector2& position, float radius);
 
+    // Moving objects, emptied on every generate()
+    SpatialGrid& get_objects() { return objects; }
+
+    // Holds every per-level container, rewound at the start of generate()
+    const Arena& get_level_arena() const { return levelArena; }
+
     Vector3 get_spawn_position() const
     {
-        if (rooms.empty()) { return position; }
-    
-        const Room& firstRoom = rooms.front();
-        // Calculate center of the first room in map coordinates
-        float centerX = firstRoom.x + (firstRoom.width / 2.0f);
-        float centerY = firstRoom.y + (firstRoom.height / 2.0f);
-    
+        // spawnPoint is in map coordinates
         return Vector3
         {
-            position.x + centerX,
+            position.x + spawnPoint.x,
             0.4f,                 
-            position.z + centerY  
+            position.z + spawnPoint.y  
         };
     }
     
 private:
+    void resetLevel();
+    bool generateRooms();
+    bool generateCaves();
     void initializeMap();
     void createRoom(const Room& room);
     void createCorridor(int x1, int y1, int x2, int y2);
     bool isRoomValid(const Room& room) const;
-    void generateMesh();
-    Color* createMapPixels() const;
+    bool generateMesh();    // False when the mesh memory couldn't be allocated
+    void unloadMesh();
+    bool isSolid(int x, int y) const;
+    void updateMinimapPixels(int minX, int minY, int maxX, int maxY);   // Cells, inclusive
     
-    static constexpr int MAP_WIDTH = 32;
-    static constexpr int MAP_HEIGHT = 32;
-    static constexpr int MIN_ROOM_SIZE = 4;
-    static constexpr int MAX_ROOM_SIZE = 6;
-    static constexpr int MAX_ROOMS = 10;
-    
-    Model model;
+    Platform& platform;
+    Arena levelArena;   // Declared first so it outlives the containers allocating from it
+    std::pmr::vector<Mesh> cellMeshes;   // One per portal graph cell
+    Material material;
     Texture2D cubicmap;
     Texture2D texture;
-    Color* mapPixels;
     Vector3 position;
     static constexpr Vector3 MAP_POSITION{ -16.0f, 0.0f, -8.0f };
+    MapStyle style;
+    MapConfig config;
+    const MapKernelTable* kernels;  // Specialised for the map size when there is a version for it
+    Vector2 spawnPoint;
     
-    std::vector<std::vector<CellType>> mapData;
-    std::vector<Room> rooms;
+    std::pmr::vector<CellType> mapData; // Row-major, config.width cells per row
+    std::pmr::vector<Room> rooms;
+
+    // Rooms and corridors as cells with the openings between them
+    PortalGraph portalGraph;
+    std::pmr::vector<int> visibleCells;
+
+    SpatialGrid objects;
     
-    std::vector<std::vector<bool>> visibilityMap;
+    std::pmr::vector<char> visibilityMap;
     static constexpr float VISIBILITY_RADIUS = 5.0f;  // How far the player can "see"
-    
-    // Helper method to update visibility
-    void updateVisibility(const Vector2& playerPos);
+
+    // Past MINIMAP_SIZE cells a side several cells share a minimap pixel. Those pixels are
+    // built once per level and then redone only where update_visibility changed something.
+    std::pmr::vector<Color> minimapPixels;
+    int minimapCellsPerPixel;
+    int minimapWidth;
+    int minimapHeight;
+    static constexpr int MINIMAP_SIZE = 128;
+
 };
\ No newline at end of file
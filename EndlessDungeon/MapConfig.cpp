@@ -0,0 +1,120 @@
+#include "MapConfig.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+    std::string trim(const std::string& text)
+    {
+        size_t start = text.find_first_not_of(" \t\r");
+        if (start == std::string::npos) { return std::string(); }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(start, end - start + 1);
+    }
+}
+
+bool MapConfig::load(const char* path, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = std::string("can't open ") + path;
+        return false;
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+        {
+            error = std::string(path) + ":" + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+        if (!set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)), error))
+        {
+            error = std::string(path) + ":" + std::to_string(lineNumber) + ": " + error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MapConfig::set(const std::string& key, const std::string& value, std::string& error)
+{
+    char* end = nullptr;
+    long number = strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0')
+    {
+        error = "'" + value + "' is not a number for " + key;
+        return false;
+    }
+
+    int* setting = key == "width" ? &width :
+        key == "height" ? &height :
+        key == "min_room_size" ? &minRoomSize :
+        key == "max_room_size" ? &maxRoomSize :
+        key == "max_rooms" ? &maxRooms :
+        key == "min_rooms" ? &minRooms : nullptr;
+    if (!setting)
+    {
+        error = "unknown setting '" + key + "'";
+        return false;
+    }
+
+    *setting = static_cast<int>(std::max(-1L, std::min(number, 1L << 30)));
+    return true;
+}
+
+bool MapConfig::validate(MapStyle style, std::string& error) const
+{
+    const int maxSize = style == MapStyle::CAVES ? MAX_CAVE_SIZE : MAX_SIZE;
+    if (width < MIN_SIZE || width > maxSize || height < MIN_SIZE || height > maxSize)
+    {
+        error = "map size must be between " + std::to_string(MIN_SIZE) + " and " + std::to_string(maxSize) +
+            (style == MapStyle::CAVES ? " for caves" : "");
+        return false;
+    }
+    // The room settings only matter to the rooms generator
+    if (style != MapStyle::ROOMS)
+    {
+        return true;
+    }
+
+    if (minRoomSize < 1 || maxRoomSize < minRoomSize)
+    {
+        error = "room sizes need 1 <= min_room_size <= max_room_size";
+        return false;
+    }
+    if (maxRoomSize > std::min(width, height) - 3)
+    {
+        error = "max_room_size must leave a wall on every side of the map";
+        return false;
+    }
+    if (minRooms < 1 || maxRooms < minRooms)
+    {
+        error = "room counts need 1 <= min_rooms <= max_rooms";
+        return false;
+    }
+
+    // Rooms keep a wall between each other and the map edge, so only so many of the smallest size fit
+    const int roomsThatFit = ((width - 2) / (minRoomSize + 1)) * ((height - 2) / (minRoomSize + 1));
+    if (minRooms > roomsThatFit)
+    {
+        error = "min_rooms is " + std::to_string(minRooms) + " but at most " + std::to_string(roomsThatFit) +
+            " rooms of min_room_size fit in the map";
+        return false;
+    }
+    if (maxRooms > roomsThatFit)
+    {
+        error = "max_rooms is " + std::to_string(maxRooms) + " but at most " + std::to_string(roomsThatFit) +
+            " rooms of min_room_size fit in the map";
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+
+enum class MapStyle {
+    ROOMS = 0,  // Rectangular rooms linked by L-shaped corridors
+    CAVES = 1   // Cellular automaton caves
+};
+
+// Size and generation settings of a map, from a config file or the command line.
+// The defaults are the original 32x32 dungeon.
+struct MapConfig {
+    int width = 32;
+    int height = 32;
+    int minRoomSize = 4;
+    int maxRoomSize = 6;
+    int maxRooms = 10;
+    int minRooms = 6;   // Layouts with fewer rooms are thrown away and rolled again
+
+    // "key = value" per line, # starts a comment. Keys are the ones set() takes.
+    bool load(const char* path, std::string& error);
+
+    // width, height, min_room_size, max_room_size, max_rooms or min_rooms
+    bool set(const std::string& key, const std::string& value, std::string& error);
+
+    // For rooms, rooms have to fit inside the map with a wall around them, and min_rooms
+    // and max_rooms of the smallest size have to fit at all. Generation can still fail on
+    // a tight fit. Caves ignore the room settings but are capped at MAX_CAVE_SIZE.
+    bool validate(MapStyle style, std::string& error) const;
+
+    static constexpr int MIN_SIZE = 8;
+    static constexpr int MAX_SIZE = 4096;
+    static constexpr int MAX_CAVE_SIZE = 256;   // A cave is one mesh drawn whole every frame
+};
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "MapKernels.h"
+
+const MapKernelTable& SelectMapKernels(int width, int height)
+{
+    if (width == 32 && height == 32) { return MapKernels<FixedGrid<32, 32>>::TABLE; }
+    if (width == 64 && height == 64) { return MapKernels<FixedGrid<64, 64>>::TABLE; }
+    if (width == 128 && height == 128) { return MapKernels<FixedGrid<128, 128>>::TABLE; }
+    return MapKernels<DynamicGrid>::TABLE;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+#include "raylib.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Map dimensions baked in at compile time, so row offsets fold into shifts and
+// loops over the whole map have a known trip count
+template <int WIDTH, int HEIGHT>
+struct FixedGrid {
+    FixedGrid(int, int) {}
+    static constexpr int width = WIDTH;
+    static constexpr int height = HEIGHT;
+};
+
+// Any map size, read at run time
+struct DynamicGrid {
+    DynamicGrid(int gridWidth, int gridHeight) : width(gridWidth), height(gridHeight) {}
+    const int width;
+    const int height;
+};
+
+// Per-frame map kernels picked once per level, see SelectMapKernels
+struct MapKernelTable {
+    bool (*check_collision)(const CellType* cells, int width, int height, const Vector2& origin, const Vector2& position, float radius);
+    void (*update_visibility)(const CellType* cells, char* visible, int width, int height, int playerX, int playerY, float radius);
+    void (*create_map_pixels)(const CellType* cells, const char* visible, int width, int height, Color* pixels);
+};
+
+// Cells are row-major, origin is the world position of cell (0, 0) on the XZ plane
+template <typename Grid>
+struct MapKernels
+{
+    static_assert(sizeof(Color) == sizeof(uint32_t), "create_map_pixels writes colours as words");
+
+    static uint32_t packColor(Color color)
+    {
+        uint32_t word;
+        memcpy(&word, &color, sizeof(word));
+        return word;
+    }
+
+    static bool check_collision(const CellType* cells, int width, int height, const Vector2& origin, const Vector2& position, float radius)
+    {
+        const Grid grid(width, height);
+
+        // Only walls under the circle's bounds can touch it, with a cell of slack either side
+        const int minX = std::max(0, static_cast<int>(floorf(position.x - origin.x - radius - 0.5f)) - 1);
+        const int maxX = std::min(grid.width - 1, static_cast<int>(floorf(position.x - origin.x + radius + 0.5f)) + 1);
+        const int minY = std::max(0, static_cast<int>(floorf(position.y - origin.y - radius - 0.5f)) - 1);
+        const int maxY = std::min(grid.height - 1, static_cast<int>(floorf(position.y - origin.y + radius + 0.5f)) + 1);
+
+        for (int y = minY; y <= maxY; y++)
+        {
+            for (int x = minX; x <= maxX; x++)
+            {
+                if (cells[y * grid.width + x] != CellType::WALL)
+                    continue;
+
+                Rectangle cellBounds{
+                    origin.x - 0.5f + x * 1.0f,
+                    origin.y - 0.5f + y * 1.0f,
+                    1.0f,
+                    1.0f
+                };
+                if (CheckCollisionCircleRec(position, radius, cellBounds)) { return true; }
+            }
+        }
+        return false;
+    }
+
+    static void update_visibility(const CellType* cells, char* visible, int width, int height, int playerX, int playerY, float radius)
+    {
+        const Grid grid(width, height);
+        if (playerX < 0 || playerX >= grid.width || playerY < 0 || playerY >= grid.height) { return; }
+
+        const int reach = static_cast<int>(radius);
+        for (int y = -reach; y <= reach; y++)
+        {
+            for (int x = -reach; x <= reach; x++)
+            {
+                int checkX = playerX + x;
+                int checkY = playerY + y;
+                if (checkX < 0 || checkX >= grid.width || checkY < 0 || checkY >= grid.height)
+                    continue;
+
+                float distance = sqrtf(static_cast<float>(x * x + y * y));
+                if (distance > radius)
+                    continue;
+
+                // Simple line of sight check
+                bool hasLineOfSight = true;
+                float dx = static_cast<float>(x);
+                float dy = static_cast<float>(y);
+                float steps = distance * 2;
+                for (float i = 0; i < steps; i++)
+                {
+                    int checkStepX = playerX + static_cast<int>(dx * (i / steps));
+                    int checkStepY = playerY + static_cast<int>(dy * (i / steps));
+                    if (cells[checkStepY * grid.width + checkStepX] == CellType::WALL)
+                    {
+                        hasLineOfSight = false;
+                        break;
+                    }
+                }
+
+                if (hasLineOfSight)
+                {
+                    visible[checkY * grid.width + checkX] = 1;
+                }
+            }
+        }
+    }
+
+    static void create_map_pixels(const CellType* cells, const char* visible, int width, int height, Color* pixels)
+    {
+        // Colours as packed words and masks instead of branches, so the loop vectorizes
+        const uint32_t fog = packColor(DARKGRAY);
+        const uint32_t wall = packColor(WHITE);
+        const uint32_t floor = packColor(BLACK);
+
+        const Grid grid(width, height);
+        uint32_t* out = reinterpret_cast<uint32_t*>(pixels);
+        for (int i = 0; i < grid.width * grid.height; i++)
+        {
+            uint32_t seen = 0u - static_cast<uint32_t>(visible[i] != 0);
+            uint32_t isWall = 0u - static_cast<uint32_t>(cells[i] == CellType::WALL);
+            out[i] = (seen & ((isWall & wall) | (~isWall & floor))) | (~seen & fog);
+        }
+    }
+
+    static constexpr MapKernelTable TABLE{ &check_collision, &update_visibility, &create_map_pixels };
+};
+
+// Specialised kernels for the common sizes, the DynamicGrid ones for anything else
+const MapKernelTable& SelectMapKernels(int width, int height);
\ No newline at end of file
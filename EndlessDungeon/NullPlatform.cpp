@@ -0,0 +1,100 @@
+#include "NullPlatform.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+void NullPlatform::InitWindow(int width, int height, const char* /*title*/)
+{
+    screenWidth = width;
+    screenHeight = height;
+}
+
+double NullPlatform::GetTime()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Texture2D NullPlatform::LoadTexture(const char* fileName)
+{
+    // Decoding still happens on the CPU, only the upload is skipped
+    Image image = LoadImage(fileName);
+    Texture2D texture{ nextTextureId++, image.width, image.height, 1, image.format };
+    textureUploads++;
+    textureBytes += static_cast<uint64_t>(image.width) * image.height * 4;
+    UnloadImage(image);
+    return texture;
+}
+
+void NullPlatform::UploadMesh(Mesh* mesh)
+{
+    meshUploads++;
+    meshVertices += mesh->vertexCount;
+}
+
+void NullPlatform::UnloadMesh(Mesh mesh)
+{
+    // Only the CPU side exists
+    RL_FREE(mesh.vertices);
+    RL_FREE(mesh.texcoords);
+    RL_FREE(mesh.texcoords2);
+    RL_FREE(mesh.normals);
+    RL_FREE(mesh.tangents);
+    RL_FREE(mesh.colors);
+    RL_FREE(mesh.indices);
+}
+
+Material NullPlatform::LoadMaterialDefault()
+{
+    Material material{};
+    material.maps = (MaterialMap*)RL_CALLOC(MATERIAL_MAP_COUNT, sizeof(MaterialMap));
+    material.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+    return material;
+}
+
+void NullPlatform::DrawMesh(const Mesh& mesh, const Material& /*material*/, const Matrix& /*transform*/)
+{
+    drawCalls++;
+    vertices += mesh.vertexCount;
+}
+
+void NullPlatform::DrawRectangle(int /*x*/, int /*y*/, int /*width*/, int /*height*/, Color /*color*/)
+{
+    drawCalls++;
+    vertices += 4;
+}
+
+void NullPlatform::DrawRectangleLines(int /*x*/, int /*y*/, int /*width*/, int /*height*/, Color /*color*/)
+{
+    drawCalls++;
+    vertices += 8;
+}
+
+void NullPlatform::DrawText(const char* text, int /*x*/, int /*y*/, int /*fontSize*/, Color /*color*/)
+{
+    drawCalls++;
+    vertices += 4 * strlen(text);
+}
+
+Vector2 NullPlatform::MeasureText(const char* text, int fontSize)
+{
+    // No font atlas without a GPU, assume half-square glyphs
+    return Vector2{ strlen(text) * fontSize * 0.5f, static_cast<float>(fontSize) };
+}
+
+void NullPlatform::DrawTextureEx(Texture2D /*texture*/, Vector2 /*position*/, float /*rotation*/, float /*scale*/, Color /*tint*/)
+{
+    drawCalls++;
+    vertices += 4;
+}
+
+void NullPlatform::PrintStats(int frames) const
+{
+    if (frames <= 0) { return; }
+
+    printf("Null renderer: %.1f draws/frame, %.0f vertices/frame\n",
+        static_cast<double>(drawCalls) / frames, static_cast<double>(vertices) / frames);
+    printf("  %llu texture uploads (%llu KB), %llu mesh uploads (%llu vertices)\n",
+        static_cast<unsigned long long>(textureUploads), static_cast<unsigned long long>(textureBytes / 1024),
+        static_cast<unsigned long long>(meshUploads), static_cast<unsigned long long>(meshVertices));
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include "Platform.h"
+#include <cstdint>
+
+// Executes nothing and counts what would have been submitted, so the game
+// loop can run on machines without a display, GPU or audio device
+class NullPlatform : public Platform
+{
+public:
+    void InitWindow(int width, int height, const char* title) override;
+    void CloseWindow() override {}
+    bool WindowShouldClose() override { return false; }
+    void DisableCursor() override {}
+    void SetTargetFPS(int /*fps*/) override {}
+    float GetFrameTime() override { return FIXED_FRAME_TIME; }
+    double GetTime() override;
+    int GetScreenWidth() override { return screenWidth; }
+    int GetScreenHeight() override { return screenHeight; }
+
+    bool IsKeyDown(int /*key*/) override { return false; }
+    bool IsKeyPressed(int /*key*/) override { return false; }
+    bool IsMouseButtonPressed(int /*button*/) override { return false; }
+    Vector2 GetMouseDelta() override { return Vector2{ 0.0f, 0.0f }; }
+
+    void InitAudioDevice() override {}
+    void CloseAudioDevice() override {}
+    Sound LoadSound(const char* /*fileName*/) override { return Sound{}; }
+    void UnloadSound(Sound /*sound*/) override {}
+    void PlaySound(Sound /*sound*/) override {}
+
+    Texture2D LoadTexture(const char* fileName) override;
+    void UnloadTexture(Texture2D /*texture*/) override {}
+    void UploadMesh(Mesh* mesh) override;
+    void UnloadMesh(Mesh mesh) override;
+    Material LoadMaterialDefault() override;
+
+    void BeginDrawing() override {}
+    void EndDrawing() override {}
+    void ClearBackground(Color /*color*/) override {}
+    void BeginMode3D(Camera /*camera*/) override {}
+    void EndMode3D() override {}
+    void DrawMesh(const Mesh& mesh, const Material& material, const Matrix& transform) override;
+    void DrawRectangle(int x, int y, int width, int height, Color color) override;
+    void DrawRectangleLines(int x, int y, int width, int height, Color color) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    Vector2 MeasureText(const char* text, int fontSize) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+
+    void PrintStats(int frames) const override;
+
+private:
+    static constexpr float FIXED_FRAME_TIME = 1.0f / 60.0f;
+    static constexpr int MATERIAL_MAP_COUNT = 12;   // raylib's MAX_MATERIAL_MAPS
+
+    int screenWidth = 0;
+    int screenHeight = 0;
+    unsigned int nextTextureId = 1;
+
+    uint64_t drawCalls = 0;
+    uint64_t vertices = 0;
+    uint64_t textureUploads = 0;
+    uint64_t textureBytes = 0;
+    uint64_t meshUploads = 0;
+    uint64_t meshVertices = 0;
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "raylib.h"
+
+// The raylib calls the game makes that need a window, GPU or audio device.
+// Pure CPU helpers (raymath, collision checks) are still called directly.
+class Platform
+{
+public:
+    virtual ~Platform() = default;
+
+    // Window and timing
+    virtual void InitWindow(int width, int height, const char* title) = 0;
+    virtual void CloseWindow() = 0;
+    virtual bool WindowShouldClose() = 0;
+    virtual void DisableCursor() = 0;
+    virtual void SetTargetFPS(int fps) = 0;
+    virtual float GetFrameTime() = 0;
+    virtual double GetTime() = 0;
+    virtual int GetScreenWidth() = 0;
+    virtual int GetScreenHeight() = 0;
+
+    // Input
+    virtual bool IsKeyDown(int key) = 0;
+    virtual bool IsKeyPressed(int key) = 0;
+    virtual bool IsMouseButtonPressed(int button) = 0;
+    virtual Vector2 GetMouseDelta() = 0;
+
+    // Audio
+    virtual void InitAudioDevice() = 0;
+    virtual void CloseAudioDevice() = 0;
+    virtual Sound LoadSound(const char* fileName) = 0;
+    virtual void UnloadSound(Sound sound) = 0;
+    virtual void PlaySound(Sound sound) = 0;
+
+    // Resources
+    virtual Texture2D LoadTexture(const char* fileName) = 0;
+    virtual void UnloadTexture(Texture2D texture) = 0;
+    virtual void UploadMesh(Mesh* mesh) = 0;
+    virtual void UnloadMesh(Mesh mesh) = 0;
+    virtual Material LoadMaterialDefault() = 0;
+
+    // Drawing
+    virtual void BeginDrawing() = 0;
+    virtual void EndDrawing() = 0;
+    virtual void ClearBackground(Color color) = 0;
+    virtual void BeginMode3D(Camera camera) = 0;
+    virtual void EndMode3D() = 0;
+    virtual void DrawMesh(const Mesh& mesh, const Material& material, const Matrix& transform) = 0;
+    virtual void DrawRectangle(int x, int y, int width, int height, Color color) = 0;
+    virtual void DrawRectangleLines(int x, int y, int width, int height, Color color) = 0;
+    virtual void DrawText(const char* text, int x, int y, int fontSize, Color color) = 0;
+    virtual Vector2 MeasureText(const char* text, int fontSize) = 0;
+    virtual void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) = 0;
+
+    // Counters gathered by the backend, printed at the end of a run
+    virtual void PrintStats(int /*frames*/) const {}
+};
@@ -0,0 +1,278 @@
+#include "PortalGraph.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    float wrapAngle(float angle)
+    {
+        while (angle > PI) angle -= 2.0f * PI;
+        while (angle < -PI) angle += 2.0f * PI;
+        return angle;
+    }
+
+    float relativeAngle(const Vector2& eye, const Vector2& point, float viewAngle)
+    {
+        return wrapAngle(atan2f(point.y - eye.y, point.x - eye.x) - viewAngle);
+    }
+
+    float distanceToSegment(const Vector2& p, const Vector2& a, const Vector2& b)
+    {
+        float abX = b.x - a.x;
+        float abY = b.y - a.y;
+        float lengthSq = abX * abX + abY * abY;
+        float t = lengthSq > 0.0f ? ((p.x - a.x) * abX + (p.y - a.y) * abY) / lengthSq : 0.0f;
+        t = std::max(0.0f, std::min(t, 1.0f));
+        float dx = a.x + abX * t - p.x;
+        float dy = a.y + abY * t - p.y;
+        return sqrtf(dx * dx + dy * dy);
+    }
+}
+
+PortalGraph::PortalGraph(std::pmr::memory_resource* resource) :
+    cells(resource),
+    portals(resource),
+    onPath(resource),
+    visible(resource)
+{
+}
+
+void PortalGraph::build(const std::pmr::vector<CellType>& mapData, int mapWidth, int mapHeight, const std::pmr::vector<Room>& rooms, const Vector3& mapOrigin)
+{
+    width = mapWidth;
+    height = mapHeight;
+    origin = mapOrigin;
+    cells.assign(width * height, -1);
+    cellCount = 0;
+
+    labelRooms(mapData, rooms);
+    labelCorridors(mapData);
+    buildPortals();
+
+    onPath.assign(cellCount, 0);
+    visible.assign(cellCount, 0);
+}
+
+int PortalGraph::cell_at(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height) { return -1; }
+    return cells[y * width + x];
+}
+
+void PortalGraph::labelRooms(const std::pmr::vector<CellType>& mapData, const std::pmr::vector<Room>& rooms)
+{
+    // Every room is a cell of its own, corridors running through a room become part of it
+    for (const Room& room : rooms)
+    {
+        for (int y = room.y; y < room.y + room.height; y++)
+        {
+            for (int x = room.x; x < room.x + room.width; x++)
+            {
+                if (mapData[y * width + x] == CellType::FLOOR)
+                {
+                    cells[y * width + x] = cellCount;
+                }
+            }
+        }
+        cellCount++;
+    }
+}
+
+void PortalGraph::labelCorridors(const std::pmr::vector<CellType>& mapData)
+{
+    // Flood fill the remaining floor, each connected stretch of corridor becomes one cell
+    std::pmr::vector<int> stack(cells.get_allocator().resource());
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (mapData[y * width + x] != CellType::FLOOR || cells[y * width + x] != -1)
+                continue;
+
+            cells[y * width + x] = cellCount;
+            stack.push_back(y * width + x);
+            while (!stack.empty())
+            {
+                int index = stack.back();
+                stack.pop_back();
+                int cx = index % width;
+                int cy = index / width;
+
+                const int offsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+                for (const auto& offset : offsets)
+                {
+                    int nx = cx + offset[0];
+                    int ny = cy + offset[1];
+                    if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+                        continue;
+                    if (mapData[ny * width + nx] == CellType::FLOOR && cells[ny * width + nx] == -1)
+                    {
+                        cells[ny * width + nx] = cellCount;
+                        stack.push_back(ny * width + nx);
+                    }
+                }
+            }
+            cellCount++;
+        }
+    }
+}
+
+void PortalGraph::buildPortals()
+{
+    portals.clear();
+    portals.resize(cellCount);
+
+    // Openings between horizontally adjacent cells, merged into runs along each grid line
+    for (int x = 0; x < width - 1; x++)
+    {
+        int runFrom = -1, runTo = -1, runStart = 0;
+        for (int y = 0; y <= height; y++)
+        {
+            int from = y < height ? cells[y * width + x] : -1;
+            int to = y < height ? cells[y * width + x + 1] : -1;
+            bool isEdge = from >= 0 && to >= 0 && from != to;
+            if (isEdge && from == runFrom && to == runTo)
+                continue;
+
+            if (runFrom >= 0)
+            {
+                float lineX = origin.x + x + 0.5f;
+                addPortal(runFrom, runTo,
+                    Vector2{ lineX, origin.z + runStart - 0.5f },
+                    Vector2{ lineX, origin.z + y - 0.5f });
+            }
+            runFrom = isEdge ? from : -1;
+            runTo = isEdge ? to : -1;
+            runStart = y;
+        }
+    }
+
+    // Openings between vertically adjacent cells
+    for (int y = 0; y < height - 1; y++)
+    {
+        int runFrom = -1, runTo = -1, runStart = 0;
+        for (int x = 0; x <= width; x++)
+        {
+            int from = x < width ? cells[y * width + x] : -1;
+            int to = x < width ? cells[(y + 1) * width + x] : -1;
+            bool isEdge = from >= 0 && to >= 0 && from != to;
+            if (isEdge && from == runFrom && to == runTo)
+                continue;
+
+            if (runFrom >= 0)
+            {
+                float lineZ = origin.z + y + 0.5f;
+                addPortal(runFrom, runTo,
+                    Vector2{ origin.x + runStart - 0.5f, lineZ },
+                    Vector2{ origin.x + x - 0.5f, lineZ });
+            }
+            runFrom = isEdge ? from : -1;
+            runTo = isEdge ? to : -1;
+            runStart = x;
+        }
+    }
+
+    // Keep portals to the same neighbour together so traversal enters it once
+    for (std::pmr::vector<Portal>& leaving : portals)
+    {
+        std::stable_sort(leaving.begin(), leaving.end(),
+            [](const Portal& lhs, const Portal& rhs) { return lhs.to < rhs.to; });
+    }
+}
+
+void PortalGraph::addPortal(int from, int to, Vector2 a, Vector2 b)
+{
+    portals[from].push_back(Portal{ to, a, b });
+    portals[to].push_back(Portal{ from, a, b });
+}
+
+bool PortalGraph::collect_visible(const Camera& camera, float aspect, std::pmr::vector<int>& visibleCells)
+{
+    visibleCells.clear();
+
+    // Same cell lookup as Map::check_collision
+    Vector2 eye{ camera.position.x, camera.position.z };
+    int startCell = cell_at(static_cast<int>(eye.x - origin.x + 0.5f), static_cast<int>(eye.y - origin.z + 0.5f));
+    if (startCell < 0) { return false; }
+
+    float viewAngle = atan2f(camera.target.z - camera.position.z, camera.target.x - camera.position.x);
+    float halfFov = atanf(tanf(camera.fovy * 0.5f * DEG2RAD) * aspect) + ANGLE_MARGIN;
+
+    onPath.assign(cellCount, 0);
+    visible.assign(cellCount, 0);
+    traverse(startCell, eye, viewAngle, -halfFov, halfFov, 0);
+
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        if (visible[cell]) { visibleCells.push_back(cell); }
+    }
+    return true;
+}
+
+void PortalGraph::traverse(int cell, const Vector2& eye, float viewAngle, float minAngle, float maxAngle, int depth)
+{
+    visible[cell] = 1;
+    if (depth >= MAX_PORTAL_DEPTH) { return; }
+    onPath[cell] = 1;
+
+    const std::pmr::vector<Portal>& leaving = portals[cell];
+    for (size_t i = 0; i < leaving.size();)
+    {
+        // Union of what every opening into this neighbour lets through
+        const int target = leaving[i].to;
+        bool isOpen = false;
+        float openMin = 0.0f, openMax = 0.0f;
+        for (; i < leaving.size() && leaving[i].to == target; i++)
+        {
+            if (onPath[target])
+                continue;
+
+            float portalMin = minAngle, portalMax = maxAngle;
+            if (clipPortal(leaving[i], eye, viewAngle, portalMin, portalMax))
+            {
+                openMin = isOpen ? std::min(openMin, portalMin) : portalMin;
+                openMax = isOpen ? std::max(openMax, portalMax) : portalMax;
+                isOpen = true;
+            }
+        }
+
+        if (isOpen)
+        {
+            traverse(target, eye, viewAngle, openMin, openMax, depth + 1);
+        }
+    }
+
+    onPath[cell] = 0;
+}
+
+bool PortalGraph::clipPortal(const Portal& portal, const Vector2& eye, float viewAngle, float& minAngle, float& maxAngle) const
+{
+    // Standing in the opening, it can't narrow the view any further
+    if (distanceToSegment(eye, portal.a, portal.b) < NEAR_PORTAL_DISTANCE) { return true; }
+
+    float angleA = relativeAngle(eye, portal.a, viewAngle);
+    float angleB = angleA + wrapAngle(relativeAngle(eye, portal.b, viewAngle) - angleA);
+    float spanMin = std::min(angleA, angleB);
+    float spanMax = std::max(angleA, angleB);
+
+    // The span may cross the seam behind the camera, test it against the window at each wrap
+    bool isOpen = false;
+    float clippedMin = 0.0f, clippedMax = 0.0f;
+    for (float shift : { -2.0f * PI, 0.0f, 2.0f * PI })
+    {
+        float low = std::max(spanMin + shift, minAngle);
+        float high = std::min(spanMax + shift, maxAngle);
+        if (low > high)
+            continue;
+
+        clippedMin = isOpen ? std::min(clippedMin, low) : low;
+        clippedMax = isOpen ? std::max(clippedMax, high) : high;
+        isOpen = true;
+    }
+
+    if (!isOpen) { return false; }
+    minAngle = clippedMin;
+    maxAngle = clippedMax;
+    return true;
+}
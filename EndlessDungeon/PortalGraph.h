@@ -0,0 +1,55 @@
+#pragma once
+#include "raylib.h"
+#include <memory_resource>
+#include <vector>
+
+enum class CellType;
+struct Room;
+
+// Opening between two graph cells, as a segment on the XZ plane in world space
+struct Portal {
+    int to;
+    Vector2 a;
+    Vector2 b;
+};
+
+// Rooms and corridor stretches are the cells of the graph, the openings
+// between them are the portals. Built once per generated map.
+class PortalGraph
+{
+public:
+    explicit PortalGraph(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // mapData is row-major, mapWidth cells per row
+    void build(const std::pmr::vector<CellType>& mapData, int mapWidth, int mapHeight, const std::pmr::vector<Room>& rooms, const Vector3& origin);
+
+    // Collects the cells that can be seen from the camera through chains of portals.
+    // Returns false when the camera is not inside any cell.
+    bool collect_visible(const Camera& camera, float aspect, std::pmr::vector<int>& visibleCells);
+
+    int cell_at(int x, int y) const;
+    int cell_count() const { return cellCount; }
+
+private:
+    void labelRooms(const std::pmr::vector<CellType>& mapData, const std::pmr::vector<Room>& rooms);
+    void labelCorridors(const std::pmr::vector<CellType>& mapData);
+    void buildPortals();
+    void addPortal(int from, int to, Vector2 a, Vector2 b);
+    void traverse(int cell, const Vector2& eye, float viewAngle, float minAngle, float maxAngle, int depth);
+    bool clipPortal(const Portal& portal, const Vector2& eye, float viewAngle, float& minAngle, float& maxAngle) const;
+
+    static constexpr float NEAR_PORTAL_DISTANCE = 0.15f;  // Closer than this a portal is treated as fully open
+    static constexpr float ANGLE_MARGIN = 0.05f;          // Slack so cells at the screen edge don't pop
+    static constexpr int MAX_PORTAL_DEPTH = 32;
+
+    int width = 0;
+    int height = 0;
+    int cellCount = 0;
+    Vector3 origin{};
+    std::pmr::vector<int> cells;                        // Graph cell per map cell, -1 for walls
+    std::pmr::vector<std::pmr::vector<Portal>> portals; // Portals leaving each cell, grouped by target
+
+    // Traversal scratch, sized by build() so culling never allocates
+    std::pmr::vector<char> onPath;
+    std::pmr::vector<char> visible;
+};
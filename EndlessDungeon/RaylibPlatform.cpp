@@ -0,0 +1,64 @@
+#include "RaylibPlatform.h"
+
+void RaylibPlatform::InitWindow(int width, int height, const char* title) { ::InitWindow(width, height, title); }
+void RaylibPlatform::CloseWindow() { ::CloseWindow(); }
+bool RaylibPlatform::WindowShouldClose() { return ::WindowShouldClose(); }
+void RaylibPlatform::DisableCursor() { ::DisableCursor(); }
+void RaylibPlatform::SetTargetFPS(int fps) { ::SetTargetFPS(fps); }
+float RaylibPlatform::GetFrameTime() { return ::GetFrameTime(); }
+double RaylibPlatform::GetTime() { return ::GetTime(); }
+int RaylibPlatform::GetScreenWidth() { return ::GetScreenWidth(); }
+int RaylibPlatform::GetScreenHeight() { return ::GetScreenHeight(); }
+
+bool RaylibPlatform::IsKeyDown(int key) { return ::IsKeyDown(key); }
+bool RaylibPlatform::IsKeyPressed(int key) { return ::IsKeyPressed(key); }
+bool RaylibPlatform::IsMouseButtonPressed(int button) { return ::IsMouseButtonPressed(button); }
+Vector2 RaylibPlatform::GetMouseDelta() { return ::GetMouseDelta(); }
+
+void RaylibPlatform::InitAudioDevice() { ::InitAudioDevice(); }
+void RaylibPlatform::CloseAudioDevice() { ::CloseAudioDevice(); }
+Sound RaylibPlatform::LoadSound(const char* fileName) { return ::LoadSound(fileName); }
+void RaylibPlatform::UnloadSound(Sound sound) { ::UnloadSound(sound); }
+void RaylibPlatform::PlaySound(Sound sound) { ::PlaySound(sound); }
+
+Texture2D RaylibPlatform::LoadTexture(const char* fileName) { return ::LoadTexture(fileName); }
+void RaylibPlatform::UnloadTexture(Texture2D texture) { ::UnloadTexture(texture); }
+void RaylibPlatform::UploadMesh(Mesh* mesh) { ::UploadMesh(mesh, false); }
+void RaylibPlatform::UnloadMesh(Mesh mesh) { ::UnloadMesh(mesh); }
+Material RaylibPlatform::LoadMaterialDefault() { return ::LoadMaterialDefault(); }
+
+void RaylibPlatform::BeginDrawing() { ::BeginDrawing(); }
+void RaylibPlatform::EndDrawing() { ::EndDrawing(); }
+void RaylibPlatform::ClearBackground(Color color) { ::ClearBackground(color); }
+void RaylibPlatform::BeginMode3D(Camera camera) { ::BeginMode3D(camera); }
+void RaylibPlatform::EndMode3D() { ::EndMode3D(); }
+
+void RaylibPlatform::DrawMesh(const Mesh& mesh, const Material& material, const Matrix& transform)
+{
+    ::DrawMesh(mesh, material, transform);
+}
+
+void RaylibPlatform::DrawRectangle(int x, int y, int width, int height, Color color)
+{
+    ::DrawRectangle(x, y, width, height, color);
+}
+
+void RaylibPlatform::DrawRectangleLines(int x, int y, int width, int height, Color color)
+{
+    ::DrawRectangleLines(x, y, width, height, color);
+}
+
+void RaylibPlatform::DrawText(const char* text, int x, int y, int fontSize, Color color)
+{
+    ::DrawText(text, x, y, fontSize, color);
+}
+
+Vector2 RaylibPlatform::MeasureText(const char* text, int fontSize)
+{
+    return MeasureTextEx(GetFontDefault(), text, static_cast<float>(fontSize), 1);
+}
+
+void RaylibPlatform::DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint)
+{
+    ::DrawTextureEx(texture, position, rotation, scale, tint);
+}
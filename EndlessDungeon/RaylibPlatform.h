@@ -0,0 +1,46 @@
+#pragma once
+#include "Platform.h"
+
+// Forwards straight to raylib, used for normal play
+class RaylibPlatform : public Platform
+{
+public:
+    void InitWindow(int width, int height, const char* title) override;
+    void CloseWindow() override;
+    bool WindowShouldClose() override;
+    void DisableCursor() override;
+    void SetTargetFPS(int fps) override;
+    float GetFrameTime() override;
+    double GetTime() override;
+    int GetScreenWidth() override;
+    int GetScreenHeight() override;
+
+    bool IsKeyDown(int key) override;
+    bool IsKeyPressed(int key) override;
+    bool IsMouseButtonPressed(int button) override;
+    Vector2 GetMouseDelta() override;
+
+    void InitAudioDevice() override;
+    void CloseAudioDevice() override;
+    Sound LoadSound(const char* fileName) override;
+    void UnloadSound(Sound sound) override;
+    void PlaySound(Sound sound) override;
+
+    Texture2D LoadTexture(const char* fileName) override;
+    void UnloadTexture(Texture2D texture) override;
+    void UploadMesh(Mesh* mesh) override;
+    void UnloadMesh(Mesh mesh) override;
+    Material LoadMaterialDefault() override;
+
+    void BeginDrawing() override;
+    void EndDrawing() override;
+    void ClearBackground(Color color) override;
+    void BeginMode3D(Camera camera) override;
+    void EndMode3D() override;
+    void DrawMesh(const Mesh& mesh, const Material& material, const Matrix& transform) override;
+    void DrawRectangle(int x, int y, int width, int height, Color color) override;
+    void DrawRectangleLines(int x, int y, int width, int height, Color color) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    Vector2 MeasureText(const char* text, int fontSize) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+};
@@ -0,0 +1,274 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(std::pmr::memory_resource* resource) :
+    buckets(resource),
+    objects(resource)
+{
+}
+
+void SpatialGrid::reset(int gridWidth, int gridHeight, const Vector3& gridOrigin)
+{
+    width = gridWidth;
+    height = gridHeight;
+    origin = gridOrigin;
+    maxRadius = 0.0f;
+    maxRadiusCount = 0;
+    liveCount = 0;
+    freeList = -1;
+    buckets.assign(static_cast<size_t>(width) * height, -1);
+    objects.clear();
+}
+
+ObjectId SpatialGrid::insert(const Vector2& objectPosition, float radius)
+{
+    ObjectId id = freeList;
+    if (id >= 0)
+    {
+        freeList = objects[id].next;
+    }
+    else
+    {
+        id = static_cast<ObjectId>(objects.size());
+        objects.push_back(Object{});
+    }
+
+    objects[id].position = objectPosition;
+    objects[id].radius = radius;
+    if (radius > maxRadius)
+    {
+        maxRadius = radius;
+        maxRadiusCount = 0;
+    }
+    if (radius == maxRadius) { maxRadiusCount++; }
+    link(id, cellIndex(objectPosition));
+    liveCount++;
+    return id;
+}
+
+void SpatialGrid::move(ObjectId id, const Vector2& objectPosition)
+{
+    assert(isLive(id) && "moving an object that isn't in the grid");
+    if (!isLive(id)) { return; }
+
+    Object& object = objects[id];
+    object.position = objectPosition;
+
+    // Most moves stay inside the same cell and never touch the buckets
+    int cell = cellIndex(objectPosition);
+    if (cell != object.cell)
+    {
+        unlink(id);
+        link(id, cell);
+    }
+}
+
+void SpatialGrid::remove(ObjectId id)
+{
+    // Removing twice or a stale id would unlink from a bucket that doesn't exist
+    assert(isLive(id) && "removing an object that isn't in the grid");
+    if (!isLive(id)) { return; }
+
+    unlink(id);
+    objects[id].cell = -1;
+    objects[id].next = freeList;
+    freeList = id;
+    liveCount--;
+
+    // Queries only need to widen as far as the biggest object still here, that only
+    // changes once the last object of the largest radius is gone
+    if (objects[id].radius == maxRadius && --maxRadiusCount == 0)
+    {
+        maxRadius = 0.0f;
+        for (const Object& object : objects)
+        {
+            if (object.cell < 0)
+                continue;
+
+            if (object.radius > maxRadius)
+            {
+                maxRadius = object.radius;
+                maxRadiusCount = 0;
+            }
+            if (object.radius == maxRadius) { maxRadiusCount++; }
+        }
+    }
+}
+
+int SpatialGrid::query_radius(const Vector2& center, float radius, ObjectId* results, int maxResults) const
+{
+    const float reach = radius + maxRadius;
+    const int minX = cellX(center.x - reach), maxX = cellX(center.x + reach);
+    const int minY = cellY(center.y - reach), maxY = cellY(center.y + reach);
+
+    int count = 0;
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            for (int id = buckets[y * width + x]; id >= 0; id = objects[id].next)
+            {
+                const Object& object = objects[id];
+                float dx = object.position.x - center.x;
+                float dz = object.position.y - center.y;
+                float range = radius + object.radius;
+                if (dx * dx + dz * dz > range * range)
+                    continue;
+
+                if (count == maxResults) { return count; }
+                results[count++] = id;
+            }
+        }
+    }
+    return count;
+}
+
+int SpatialGrid::query_box(const Rectangle& box, ObjectId* results, int maxResults) const
+{
+    const int minX = cellX(box.x - maxRadius), maxX = cellX(box.x + box.width + maxRadius);
+    const int minY = cellY(box.y - maxRadius), maxY = cellY(box.y + box.height + maxRadius);
+
+    int count = 0;
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            for (int id = buckets[y * width + x]; id >= 0; id = objects[id].next)
+            {
+                if (!CheckCollisionCircleRec(objects[id].position, objects[id].radius, box))
+                    continue;
+
+                if (count == maxResults) { return count; }
+                results[count++] = id;
+            }
+        }
+    }
+    return count;
+}
+
+int SpatialGrid::query_ray(const Vector2& rayOrigin, const Vector2& direction, float maxDistance, RayHit* hits, int maxHits) const
+{
+    const float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    if (length <= 0.0f || maxHits <= 0) { return 0; }
+    const Vector2 dir{ direction.x / length, direction.y / length };
+
+    // Walk whole lines of cells along the ray's major axis so every cell is visited
+    // once, each line widened by maxRadius because objects can overhang their cell.
+    // "major" is x or the map's z depending on which way the ray mostly goes.
+    const bool alongX = fabsf(dir.x) >= fabsf(dir.y);
+    const float originMajor = alongX ? rayOrigin.x - origin.x + 0.5f : rayOrigin.y - origin.z + 0.5f;
+    const float originMinor = alongX ? rayOrigin.y - origin.z + 0.5f : rayOrigin.x - origin.x + 0.5f;
+    const float dirMajor = alongX ? dir.x : dir.y;
+    const float dirMinor = alongX ? dir.y : dir.x;
+    const int majorCells = alongX ? width : height;
+    const int minorCells = alongX ? height : width;
+
+    const float endMajor = originMajor + dirMajor * maxDistance;
+    const int step = dirMajor >= 0.0f ? 1 : -1;
+    const int firstLine = std::max(0, std::min(static_cast<int>(floorf(originMajor - step * maxRadius)), majorCells - 1));
+    const int lastLine = std::max(0, std::min(static_cast<int>(floorf(endMajor + step * maxRadius)), majorCells - 1));
+
+    int count = 0;
+    for (int line = firstLine; line != lastLine + step; line += step)
+    {
+        // Part of the ray whose circles could reach into this line, the edge lines also own everything beyond the map
+        float low = line == 0 ? -INFINITY : line - maxRadius;
+        float high = line == majorCells - 1 ? INFINITY : line + 1 + maxRadius;
+        float enter = (low - originMajor) / dirMajor;
+        float exit = (high - originMajor) / dirMajor;
+        if (enter > exit) { std::swap(enter, exit); }
+
+        // Lines are visited in ray order, so once this one starts past the furthest kept hit nothing later can beat it
+        if (count == maxHits && enter > hits[count - 1].distance) { break; }
+
+        enter = std::max(enter, 0.0f);
+        exit = std::min(exit, maxDistance);
+        if (enter > exit)
+            continue;
+
+        float minorA = originMinor + dirMinor * enter;
+        float minorB = originMinor + dirMinor * exit;
+        int minMinor = std::max(0, std::min(static_cast<int>(floorf(std::min(minorA, minorB) - maxRadius)), minorCells - 1));
+        int maxMinor = std::max(0, std::min(static_cast<int>(floorf(std::max(minorA, minorB) + maxRadius)), minorCells - 1));
+
+        for (int minor = minMinor; minor <= maxMinor; minor++)
+        {
+            int cell = alongX ? minor * width + line : line * width + minor;
+            for (int id = buckets[cell]; id >= 0; id = objects[id].next)
+            {
+                const Object& object = objects[id];
+
+                // Ray against circle, a ray starting inside hits at distance 0
+                float toX = rayOrigin.x - object.position.x;
+                float toZ = rayOrigin.y - object.position.y;
+                float b = toX * dir.x + toZ * dir.y;
+                float c = toX * toX + toZ * toZ - object.radius * object.radius;
+                float distance = 0.0f;
+                if (c > 0.0f)
+                {
+                    float discriminant = b * b - c;
+                    if (b > 0.0f || discriminant < 0.0f)
+                        continue;
+                    distance = -b - sqrtf(discriminant);
+                }
+                if (distance > maxDistance)
+                    continue;
+
+                // Keep the closest maxHits, sorted
+                if (count == maxHits && distance >= hits[count - 1].distance)
+                    continue;
+                int slot = count < maxHits ? count++ : count - 1;
+                while (slot > 0 && hits[slot - 1].distance > distance)
+                {
+                    hits[slot] = hits[slot - 1];
+                    slot--;
+                }
+                hits[slot] = RayHit{ id, distance };
+            }
+        }
+    }
+    return count;
+}
+
+bool SpatialGrid::isLive(ObjectId id) const
+{
+    return id >= 0 && id < static_cast<ObjectId>(objects.size()) && objects[id].cell >= 0;
+}
+
+int SpatialGrid::cellIndex(const Vector2& objectPosition) const
+{
+    return cellY(objectPosition.y) * width + cellX(objectPosition.x);
+}
+
+int SpatialGrid::cellX(float worldX) const
+{
+    // Same cell centres as Map::check_collision, clamped so stray objects land on the border
+    int x = static_cast<int>(floorf(worldX - origin.x + 0.5f));
+    return std::max(0, std::min(x, width - 1));
+}
+
+int SpatialGrid::cellY(float worldZ) const
+{
+    int y = static_cast<int>(floorf(worldZ - origin.z + 0.5f));
+    return std::max(0, std::min(y, height - 1));
+}
+
+void SpatialGrid::link(ObjectId id, int cell)
+{
+    Object& object = objects[id];
+    object.cell = cell;
+    object.prev = -1;
+    object.next = buckets[cell];
+    if (object.next >= 0) { objects[object.next].prev = id; }
+    buckets[cell] = id;
+}
+
+void SpatialGrid::unlink(ObjectId id)
+{
+    Object& object = objects[id];
+    if (object.prev >= 0) { objects[object.prev].next = object.next; }
+    else { buckets[object.cell] = object.next; }
+    if (object.next >= 0) { objects[object.next].prev = object.prev; }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include "raylib.h"
+#include <memory_resource>
+#include <vector>
+
+using ObjectId = int;
+
+struct RayHit {
+    ObjectId id;
+    float distance;
+};
+
+// Loose grid for moving objects (enemies, pickups, projectiles), one bucket per
+// map cell using the same cell maths as Map::check_collision. Objects sit in the
+// bucket of their centre, queries widen by the largest radius in the grid. Buckets are
+// intrusive lists so inserts, moves and removals don't allocate. Removing the last
+// object with the largest radius rescans the rest to shrink that margin again.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // origin is the world position of cell (0, 0), as Map's position
+    void reset(int width, int height, const Vector3& origin);
+
+    // Moving or removing an id that was already removed asserts and does nothing
+    ObjectId insert(const Vector2& position, float radius);
+    void move(ObjectId id, const Vector2& position);
+    void remove(ObjectId id);
+
+    Vector2 get_position(ObjectId id) const { return objects[id].position; }
+    float get_radius(ObjectId id) const { return objects[id].radius; }
+    int object_count() const { return liveCount; }
+
+    // Queries write into the caller's buffer and return how many were written
+    int query_radius(const Vector2& center, float radius, ObjectId* results, int maxResults) const;
+    int query_box(const Rectangle& box, ObjectId* results, int maxResults) const;
+
+    // Nearest hits along the ray, closest first. direction needn't be normalized.
+    int query_ray(const Vector2& origin, const Vector2& direction, float maxDistance, RayHit* hits, int maxHits) const;
+
+private:
+    struct Object {
+        Vector2 position;
+        float radius;
+        int cell;   // -1 when free
+        int next;   // Next object in the same bucket, or next free slot
+        int prev;
+    };
+
+    bool isLive(ObjectId id) const;
+    int cellIndex(const Vector2& position) const;
+    int cellX(float worldX) const;
+    int cellY(float worldZ) const;
+    void link(ObjectId id, int cell);
+    void unlink(ObjectId id);
+
+    int width = 0;
+    int height = 0;
+    Vector3 origin{};
+    float maxRadius = 0.0f;
+    int maxRadiusCount = 0;     // Live objects with radius == maxRadius
+    int liveCount = 0;
+    int freeList = -1;
+    std::pmr::vector<int> buckets;  // First object per cell, -1 when empty
+    std::pmr::vector<Object> objects;
+};
\ No newline at end of file
@@ -2,7 +2,8 @@
 
 #include <cstdio>
 
-Weapon::Weapon() : 
+Weapon::Weapon(Platform& platformRef) : 
+    platform(platformRef),
     isShooting(false), 
     isReloading(false),
     currentFrame(0), 
@@ -20,7 +21,7 @@ Weapon::~Weapon()
 
 void Weapon::Initialize()
 {
-    InitAudioDevice();
+    platform.InitAudioDevice();
     LoadTextures();
     GunSound();
 }
@@ -31,20 +32,20 @@ void Weapon::LoadTextures()
         {
         char filename[256];
         sprintf_s(filename, "resources/pistol%d.png", i + 1);
-        pistolTextures[i] = LoadTexture(filename);
+        pistolTextures[i] = platform.LoadTexture(filename);
     }
 }
 
-void Weapon::GunSound() { shootSound = LoadSound("resources/GunShot.wav"); }
+void Weapon::GunSound() { shootSound = platform.LoadSound("resources/GunShot.wav"); }
 
-void Weapon::Update()
+void Weapon::Update(const Input& input)
 {
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !isShooting && !isReloading && currentAmmo > 0)
+    if (input.is_mouse_button_pressed(MOUSE_LEFT_BUTTON) && !isShooting && !isReloading && currentAmmo > 0)
     {
         isShooting = true;
         currentFrame = 0;
         frameTimer = 0.0f;
-        PlaySound(shootSound);
+        platform.PlaySound(shootSound);
         currentAmmo--;
     }
     
@@ -56,7 +57,7 @@ void Weapon::Update()
     }
     
     // Manual reload with R key
-    if (IsKeyPressed(KEY_R) && !isReloading && currentAmmo < MAGAZINE_SIZE && totalAmmo > 0)
+    if (input.is_key_pressed(KEY_R) && !isReloading && currentAmmo < MAGAZINE_SIZE && totalAmmo > 0)
     {
         isReloading = true;
         reloadTimer = RELOAD_TIME;
@@ -65,7 +66,7 @@ void Weapon::Update()
     // Handle reloading
     if (isReloading)
     {
-        reloadTimer -= GetFrameTime();
+        reloadTimer -= input.get_frame_time();
         if (reloadTimer <= 0)
         {
             Reload();
@@ -74,7 +75,7 @@ void Weapon::Update()
     
     if (isShooting)
     {
-        frameTimer += GetFrameTime();
+        frameTimer += input.get_frame_time();
         
         if (frameTimer >= ANIMATION_FRAME_TIME)
         {
@@ -102,8 +103,8 @@ void Weapon::Reload()
 
 void Weapon::DrawAmmoCounter()
 {
-    int screenWidth = GetScreenWidth();
-    int screenHeight = GetScreenHeight();
+    int screenWidth = platform.GetScreenWidth();
+    int screenHeight = platform.GetScreenHeight();
     
     const int MARGIN = 20;
     const int fontSize = 30;
@@ -111,9 +112,9 @@ void Weapon::DrawAmmoCounter()
     char ammoText[32];
     sprintf_s(ammoText, "%d/%d", currentAmmo, totalAmmo);
     
-    Vector2 textSize = MeasureTextEx(GetFontDefault(), ammoText, fontSize, 1);
+    Vector2 textSize = platform.MeasureText(ammoText, fontSize);
     
-    DrawText(ammoText, 
+    platform.DrawText(ammoText, 
         screenWidth - textSize.x - MARGIN, 
         screenHeight - fontSize - MARGIN,
         fontSize, 
@@ -122,9 +123,9 @@ void Weapon::DrawAmmoCounter()
     if (isReloading)
     {
         const char* reloadText = "RELOADING";
-        Vector2 reloadTextSize = MeasureTextEx(GetFontDefault(), reloadText, fontSize, 1);
+        Vector2 reloadTextSize = platform.MeasureText(reloadText, fontSize);
         
-        DrawText(reloadText,
+        platform.DrawText(reloadText,
             screenWidth - reloadTextSize.x - MARGIN,
             screenHeight - (fontSize * 2) - MARGIN - 5,
             fontSize,
@@ -137,8 +138,8 @@ void Weapon::Draw()
     DrawCrosshair();
     DrawAmmoCounter();
     
-    int screenWidth = GetScreenWidth();
-    int screenHeight = GetScreenHeight();
+    int screenWidth = platform.GetScreenWidth();
+    int screenHeight = platform.GetScreenHeight();
     
     const float WEAPON_SCALE = 4.0f; 
     Texture2D currentTexture = pistolTextures[currentFrame];
@@ -150,7 +151,7 @@ void Weapon::Draw()
     float posY = screenHeight - weaponHeight ;  
     
     // Draw the current frame
-    DrawTextureEx(
+    platform.DrawTextureEx(
         currentTexture,
         { posX, posY },
         0.0f,  // rotation
@@ -163,25 +164,25 @@ void Weapon::Unload()
 {
     for (int i = 0; i < TOTAL_FRAMES; i++)
     {
-        UnloadTexture(pistolTextures[i]);
+        platform.UnloadTexture(pistolTextures[i]);
     }
     
-    UnloadSound(shootSound);
+    platform.UnloadSound(shootSound);
 }
 void Weapon::DrawCrosshair()
 {
-    int centerX = GetScreenWidth() / 2;
-    int centerY = GetScreenHeight() / 2;
+    int centerX = platform.GetScreenWidth() / 2;
+    int centerY = platform.GetScreenHeight() / 2;
     const int SIZE = 10;
     const int GAP = 4;
     const int THICKNESS = 2;
     const Color CROSSHAIR_COLOR = RAYWHITE;
     
     // Horizontal lines
-    DrawRectangle(centerX - SIZE - GAP, centerY - THICKNESS/2, SIZE, THICKNESS, CROSSHAIR_COLOR);
-    DrawRectangle(centerX + GAP, centerY - THICKNESS/2, SIZE, THICKNESS, CROSSHAIR_COLOR);
+    platform.DrawRectangle(centerX - SIZE - GAP, centerY - THICKNESS/2, SIZE, THICKNESS, CROSSHAIR_COLOR);
+    platform.DrawRectangle(centerX + GAP, centerY - THICKNESS/2, SIZE, THICKNESS, CROSSHAIR_COLOR);
     
     // Vertical lines
-    DrawRectangle(centerX - THICKNESS/2, centerY - SIZE - GAP, THICKNESS, SIZE, CROSSHAIR_COLOR);
-    DrawRectangle(centerX - THICKNESS/2, centerY + GAP, THICKNESS, SIZE, CROSSHAIR_COLOR);
+    platform.DrawRectangle(centerX - THICKNESS/2, centerY - SIZE - GAP, THICKNESS, SIZE, CROSSHAIR_COLOR);
+    platform.DrawRectangle(centerX - THICKNESS/2, centerY + GAP, THICKNESS, SIZE, CROSSHAIR_COLOR);
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 #include "raylib.h"
+#include "Input.h"
+#include "Platform.h"
 
 class Weapon {
 public:
-    Weapon();
+    Weapon(Platform& platformRef);
     ~Weapon();
     void Initialize();
-    void Update();
+    void Update(const Input& input);
     void Draw();
     void Unload();
 
@@ -18,6 +20,7 @@ private:
     static constexpr int MAX_TOTAL_AMMO = 64;   
     static constexpr int STARTING_TOTAL_AMMO = 18; 
     
+    Platform& platform;
     Texture2D pistolTextures[TOTAL_FRAMES];
     Sound shootSound;
     bool soundLoaded;